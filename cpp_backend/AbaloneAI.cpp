@@ -5,171 +5,246 @@
 #include <chrono>
 #include <iostream>
 #include <thread>
-#include <future>
 #include <random>
 
 int STARTING_MARBLES = 14; // Number of marbles each player starts with
 int WIN_THRESHOLD = 6; // Number of marbles pushed off to win
 int ENDGAME = STARTING_MARBLES - WIN_THRESHOLD; // Number of marbles left for endgame
 
-// Modify evaluatePosition to adjust weights based on game phase
-int AbaloneAI::evaluatePosition(const Board& board, float gameProgress) {
-    nodesEvaluated++;
+namespace {
+
+// Evaluation weights at one end of the game. Positions are scored with a blend
+// of the two sets, weighted by how far the game has progressed on the board.
+struct EvalWeights {
+    int marble;
+    int decisiveMarble;   // marble weight once the side to move is one capture from winning
+    int center;
+    int cohesion;
+    int edge;
+    int threat;
+};
+
+constexpr EvalWeights MIDGAME_WEIGHTS = { 100, 100, 15, 5, 15, 10 };
+constexpr EvalWeights ENDGAME_WEIGHTS = { 100, 1000, 20, 10, 20, 10 };
+
+// Game phase from the marbles left on the board: 0 with all of them, PHASE_MAX
+// once ENDGAME_MARBLES_LOST have been pushed off.
+constexpr int TOTAL_MARBLES = 28;
+constexpr int ENDGAME_MARBLES_LOST = 8;
+constexpr int PHASE_MAX = 256;
+
+constexpr int phaseOf(int marblesOnBoard) {
+    int lost = TOTAL_MARBLES - marblesOnBoard;
+    lost = lost < 0 ? 0 : (lost > ENDGAME_MARBLES_LOST ? ENDGAME_MARBLES_LOST : lost);
+    return lost * PHASE_MAX / ENDGAME_MARBLES_LOST;
+}
+
+constexpr int taper(int midgame, int endgame, int phase) {
+    return (midgame * (PHASE_MAX - phase) + endgame * phase) / PHASE_MAX;
+}
 
-    // Count marbles for each side
-    int blackMarbles = 0;
-    int whiteMarbles = 0;
-    for (int i = 0; i < Board::NUM_CELLS; i++) {
-        if (board.occupant[i] == Occupant::BLACK)
-            blackMarbles++;
-        else if (board.occupant[i] == Occupant::WHITE)
-            whiteMarbles++;
+// TAPERED_WEIGHTS[marbles on the board]: the blended weights for that phase.
+constexpr std::array<EvalWeights, TOTAL_MARBLES + 1> makeTaperedWeights() {
+    std::array<EvalWeights, TOTAL_MARBLES + 1> table{};
+    for (int marbles = 0; marbles <= TOTAL_MARBLES; marbles++) {
+        int phase = phaseOf(marbles);
+        table[marbles] = {
+            taper(MIDGAME_WEIGHTS.marble, ENDGAME_WEIGHTS.marble, phase),
+            taper(MIDGAME_WEIGHTS.decisiveMarble, ENDGAME_WEIGHTS.decisiveMarble, phase),
+            taper(MIDGAME_WEIGHTS.center, ENDGAME_WEIGHTS.center, phase),
+            taper(MIDGAME_WEIGHTS.cohesion, ENDGAME_WEIGHTS.cohesion, phase),
+            taper(MIDGAME_WEIGHTS.edge, ENDGAME_WEIGHTS.edge, phase),
+            taper(MIDGAME_WEIGHTS.threat, ENDGAME_WEIGHTS.threat, phase),
+        };
     }
+    return table;
+}
 
-    // Check if we're in endgame with tied scores
-    bool scoresTied = blackMarbles == whiteMarbles;
-    bool endgameNear = gameProgress >= 0.9f;
-    bool midGame = gameProgress >= 0.3f;
+constexpr std::array<EvalWeights, TOTAL_MARBLES + 1> TAPERED_WEIGHTS = makeTaperedWeights();
 
-    bool closeToWin = false;
-    if (board.nextToMove == Occupant::BLACK) {
-        closeToWin = (whiteMarbles - 1) == ENDGAME;
-    }
-    else {
-        closeToWin = (blackMarbles - 1) == ENDGAME;
-    }
+const EvalWeights& weightsFor(const EvalFeatures& features) {
+    int marbles = std::min(features.marbles[0] + features.marbles[1], TOTAL_MARBLES);
+    return TAPERED_WEIGHTS[marbles];
+}
 
-    // Base marble count evaluation
-    int score = (blackMarbles - whiteMarbles) * MARBLE_VALUE;
+} // namespace
 
-    // If we're in endgame with tied scores, dramatically increase the value of having fewer marbles
-    // (which means we've pushed more off)
-    if (scoresTied && endgameNear || closeToWin && endgameNear) {
-        score = (blackMarbles - whiteMarbles) * MARBLE_VALUE * 10; // 10x importance
+int AbaloneAI::evaluatePosition(const Board& board) {
+    uint64_t key = board.hash();
+    int score;
+    if (evalCache.probe(key, score)) {
+        return score;
     }
+    score = evaluateFeatures(board.nextToMove, computeFeatures(board));
+    evalCache.store(key, score);
+    return score;
+}
 
-    // Adjust weights based on game phase
-    int marbleValue = MARBLE_VALUE;
-    int centerValue = 15;
-    int cohesionValue = 5;
-    int edgeValue = 15;
-    int threatValue = 10;
+int AbaloneAI::evaluateFeatures(Occupant toMove, const EvalFeatures& features) {
+    const EvalWeights& weights = weightsFor(features);
+    int blackMarbles = features.marbles[0];
+    int whiteMarbles = features.marbles[1];
 
-    if (gameProgress >= 0.5f) {
-        // Mid-game: increase center control and cohesion values
-        edgeValue = 20;
-        cohesionValue = 10;
-        centerValue = 20;
-    }
+    // One more capture by the side to move wins: the marble count is what matters now.
+    int opponentMarbles = (toMove == Occupant::BLACK) ? whiteMarbles : blackMarbles;
+    int marbleValue = (opponentMarbles - 1 == ENDGAME) ? weights.decisiveMarble : weights.marble;
+
+    int score = (blackMarbles - whiteMarbles) * marbleValue;
 
     // Center control
-    int blackCenterControl = 0;
-    int whiteCenterControl = 0;
-    std::vector<int> centerCells = {
-        Board::notationToIndex("E5"),
-        Board::notationToIndex("D5"),
-        Board::notationToIndex("F5"),
-        Board::notationToIndex("E4"),
-        Board::notationToIndex("E6")
-    };
-    for (int idx : centerCells) {
-        if (idx >= 0) {
-            if (board.occupant[idx] == Occupant::BLACK)
-                blackCenterControl++;
-            else if (board.occupant[idx] == Occupant::WHITE)
-                whiteCenterControl++;
-        }
-    }
-    score += (blackCenterControl - whiteCenterControl) * centerValue;
+    score += (features.center[0] - features.center[1]) * weights.center;
 
     // Group cohesion
-    int blackCohesion = calculateCohesion(board, Occupant::BLACK);
-    int whiteCohesion = calculateCohesion(board, Occupant::WHITE);
-    score += (blackCohesion - whiteCohesion) * cohesionValue;
+    score += (features.cohesion[0] - features.cohesion[1]) * weights.cohesion;
 
     // Edge danger
-    int blackEdgeDanger = calculateEdgeDanger(board, Occupant::BLACK);
-    int whiteEdgeDanger = calculateEdgeDanger(board, Occupant::WHITE);
-    score -= (blackEdgeDanger - whiteEdgeDanger) * edgeValue;
+    score -= (features.edge[0] - features.edge[1]) * weights.edge;
 
     // Threat potential
-    int blackThreats = calculateThreatPotential(board, Occupant::BLACK);
-    int whiteThreats = calculateThreatPotential(board, Occupant::WHITE);
-    score += (blackThreats - whiteThreats) * threatValue;
+    score += (features.threats[0] - features.threats[1]) * weights.threat;
 
     return score;
 }
 
+EvalFeatures AbaloneAI::computeFeatures(const Board& board) {
+    EvalFeatures features;
+    for (int s = 0; s < 2; s++) {
+        Occupant side = (s == 0) ? Occupant::BLACK : Occupant::WHITE;
+        uint64_t own = board.getBitboard(side);
+        features.marbles[s] = Board::popcount(own);
+        features.center[s] = Board::popcount(own & CENTER_MASK);
+        features.cohesion[s] = calculateCohesion(board, side);
+        features.edge[s] = calculateEdgeDanger(board, side);
+        features.threats[s] = calculateThreatPotential(board, side);
+    }
+    return features;
+}
+
+void AbaloneAI::evaluateChildren(SearchWorker& worker, const Board& board, const MoveList& moves, int* scores) {
+    // Children found in the cache are answered from it; the rest go through EvalBatch together.
+    auto& children = worker.childPositions;
+    auto& keys = worker.childKeys;
+    auto& missing = worker.childMoves;
+    auto& features = worker.childFeatures;
+    int missCount = 0;
+
+    uint64_t parentKey = board.hash();
+    for (int i = 0; i < moves.size(); i++) {
+        std::array<uint64_t, 2> after = board.bitboardsAfter(moves[i]);
+        uint64_t key = parentKey;
+        for (int s = 0; s < 2; s++) {
+            uint64_t changed = board.bitboards[s] ^ after[s];
+            for (; changed; changed &= changed - 1) {
+                key ^= Zobrist::CELL_KEYS[Board::lowestSetBit(changed)][s + 1];
+            }
+        }
+        if (!evalCache.probe(key, scores[i])) {
+            children[missCount] = after;
+            keys[missCount] = key;
+            missing[missCount++] = i;
+        }
+    }
+
+    EvalBatch::computeFeatures(children.data(), missCount, features.data());
+    for (int m = 0; m < missCount; m++) {
+        int score = evaluateFeatures(board.nextToMove, features[m]);
+        evalCache.store(keys[m], score);
+        scores[missing[m]] = score;
+    }
+}
+
+void AbaloneAI::evaluateBatch(const std::array<uint64_t, 2>* positions, int count, Occupant toMove, int* scores) {
+    // In chunks, so the features stay in cache between the kernel and the weights.
+    constexpr int CHUNK = 256;
+    std::array<EvalFeatures, CHUNK> features;
+    for (int start = 0; start < count; start += CHUNK) {
+        int n = std::min(CHUNK, count - start);
+        EvalBatch::computeFeatures(positions + start, n, features.data());
+        for (int i = 0; i < n; i++) {
+            scores[start + i] = evaluateFeatures(toMove, features[i]);
+        }
+    }
+}
+
+void AbaloneAI::updateFeatures(EvalFeatures& features, const std::array<uint64_t, 2>& before,
+                               const std::array<uint64_t, 2>& after) {
+    uint64_t emptyBefore = Board::BOARD_MASK & ~(before[0] | before[1]);
+    uint64_t emptyAfter = Board::BOARD_MASK & ~(after[0] | after[1]);
+    for (int s = 0; s < 2; s++) {
+        uint64_t arrived = after[s] & ~before[s];
+        uint64_t left = before[s] & ~after[s];
+        if ((arrived | left) == 0 && emptyBefore == emptyAfter) {
+            continue;
+        }
+        features.marbles[s] += Board::popcount(arrived) - Board::popcount(left);
+        features.center[s] += Board::popcount(arrived & CENTER_MASK) - Board::popcount(left & CENTER_MASK);
+        features.edge[s] += Board::popcount(arrived & Board::s_edgeMask) - Board::popcount(left & Board::s_edgeMask);
+        features.cohesion[s] += cohesionDelta(before[s], after[s]);
+        features.threats[s] += threatPotentialDelta(before[s], emptyBefore, after[s], emptyAfter);
+    }
+}
+
+UndoInfo AbaloneAI::makeSearchMove(SearchWorker& worker, Board& board, const Move& move) {
+    std::array<uint64_t, 2> before = board.bitboards;
+    UndoInfo undo = board.makeMove(move);
+    EvalFeatures& next = worker.featureStack[worker.featureTop + 1];
+    next = worker.featureStack[worker.featureTop];
+    updateFeatures(next, before, board.bitboards);
+    worker.featureTop++;
+    return undo;
+}
+
+void AbaloneAI::unmakeSearchMove(SearchWorker& worker, Board& board, const UndoInfo& undo) {
+    board.unmakeMove(undo);
+    worker.featureTop--;
+}
+
 // Evaluate a move quickly for ordering purposes
 int AbaloneAI::evaluateMove(const Board& board, const Move& move, Occupant side) {
     int score = 0;
 
     // Prioritize captures
-    if (move.pushCount > 0) {
-        score += 1000 * move.pushCount;  // Higher score for more captures
-    }
-
-    // Calculate center of the board (approximately E5 in standard notation)
-    int centerIdx = Board::notationToIndex("E5");
-
-    // Prioritize moves towards the center
-    // We'll use the end positions of the marbles after the move
-    Board tempBoard = board;
-    tempBoard.applyMove(move);
-
-    // Check if the move improves centralization
-    double beforeCentralization = 0;
-    double afterCentralization = 0;
-
-    for (int idx : move.marbleIndices) {
-        if (idx >= 0) {
-            // Before position - distance from center
-            auto beforeCoord = board.s_indexToCoord[idx];
-            auto centerCoord = board.s_indexToCoord[centerIdx];
-            int distBefore = std::abs(beforeCoord.first - centerCoord.first) +
-                std::abs(beforeCoord.second - centerCoord.second);
-            beforeCentralization += distBefore;
-
-            // Calculate where this marble ended up more accurately
-            // Follow the marble through to its final position after the move
-            int endIdx = idx;
-            // First, find where this specific marble will end up in the move direction
-            if (std::find(move.marbleIndices.begin(), move.marbleIndices.end(), idx) != move.marbleIndices.end()) {
-                // Count how many marbles are ahead of this one in the move direction
-                int marblesAhead = 0;
-                int currentIdx = idx;
-                for (int i = 0; i < move.marbleIndices.size(); i++) {
-                    int nextIdx = board.neighbors[currentIdx][move.direction];
-                    if (nextIdx >= 0 && std::find(move.marbleIndices.begin(), move.marbleIndices.end(), nextIdx) != move.marbleIndices.end()) {
-                        marblesAhead++;
-                        currentIdx = nextIdx;
-                    } else {
-                        break;
-                    }
-                }
-                
-                // Trace the path to the final position, accounting for any pushed marbles
-                endIdx = idx;
-                for (int i = 0; i <= marblesAhead; i++) {
-                    int nextIdx = board.neighbors[endIdx][move.direction];
-                    if (nextIdx >= 0) {
-                        endIdx = nextIdx;
-                    } else {
-                        // If we hit the edge, the marble stays at its current position
-                        // (or gets pushed off, but that's handled by the Board::applyMove)
-                        break;
-                    }
-                }
-                
-                // Only evaluate distance if the marble is still on the board
-                if (endIdx >= 0 && endIdx < Board::NUM_CELLS) {
-                    auto afterCoord = board.s_indexToCoord[endIdx];
-                    int distAfter = std::abs(afterCoord.first - centerCoord.first) +
-                        std::abs(afterCoord.second - centerCoord.second);
-                    afterCentralization += distAfter;
-                }
-            }
+    if (move.pushCount() > 0) {
+        score += 1000 * move.pushCount();  // Higher score for more captures
+    }
+
+    // Prioritize moves towards the center: Manhattan distance in (m, y) to E5
+    // of each moved marble before and after the move.
+    static const int centerIdx = Board::notationToIndex("E5");
+    auto centerDistance = [](int idx) {
+        auto coord = Board::s_indexToCoord[idx];
+        auto centerCoord = Board::s_indexToCoord[centerIdx];
+        return std::abs(coord.first - centerCoord.first) + std::abs(coord.second - centerCoord.second);
+    };
+
+    std::array<int, Move::MAX_GROUP_SIZE> group;
+    int groupSize = move.getMarbles(group);
+    int d = move.direction();
+    uint64_t groupMask = 0;
+    for (int g = 0; g < groupSize; g++) {
+        groupMask |= 1ULL << group[g];
+    }
+
+    int beforeCentralization = 0;
+    int afterCentralization = 0;
+    for (int g = 0; g < groupSize; g++) {
+        int idx = group[g];
+        beforeCentralization += centerDistance(idx);
+
+        // A marble is traced one step, plus one more for every group marble
+        // directly ahead of it, stopping at the edge. (For inline moves this
+        // credits the rear marbles with cells past the group's real destination;
+        // move ordering has always been tuned with it.)
+        int marblesAhead = 0;
+        for (int cell = Board::neighbors[idx][d]; cell >= 0 && ((groupMask >> cell) & 1ULL);
+             cell = Board::neighbors[cell][d]) {
+            marblesAhead++;
+        }
+        int endIdx = idx;
+        for (int i = 0; i <= marblesAhead && Board::neighbors[endIdx][d] >= 0; i++) {
+            endIdx = Board::neighbors[endIdx][d];
         }
+        afterCentralization += centerDistance(endIdx);
     }
 
     // Add points if the move improves centralization (lower distance is better)
@@ -177,58 +252,105 @@ int AbaloneAI::evaluateMove(const Board& board, const Move& move, Occupant side)
         score += (beforeCentralization - afterCentralization) * 10;
     }
 
+    // The remaining features only change around the cells the move touches,
+    // so they are scored as deltas between the bitboards before and after.
+    std::array<uint64_t, 2> after = board.bitboardsAfter(move);
+    uint64_t ownBefore = board.getBitboard(side);
+    uint64_t ownAfter = (side == Occupant::BLACK) ? after[0] : after[1];
+    uint64_t emptyBefore = board.getEmptyBitboard();
+    uint64_t emptyAfter = Board::BOARD_MASK & ~(after[0] | after[1]);
+
     // Prioritize group-forming moves
-    int beforeCohesion = calculateCohesion(board, side);
-    int afterCohesion = calculateCohesion(tempBoard, side);
-    score += (afterCohesion - beforeCohesion) * 5;
+    score += cohesionDelta(ownBefore, ownAfter) * 5;
 
     // Penalize moves that put marbles in danger
-    int beforeDanger = calculateEdgeDanger(board, side);
-    int afterDanger = calculateEdgeDanger(tempBoard, side);
-    score -= (afterDanger - beforeDanger) * 15;
+    int beforeDanger = Board::popcount(ownBefore & Board::s_edgeMask);
+    int dangerDelta = Board::popcount(ownAfter & ~ownBefore & Board::s_edgeMask)
+        - Board::popcount(ownBefore & ~ownAfter & Board::s_edgeMask);
+    score -= dangerDelta * 15;
 
     // Prioritize moves that increase threat potential
-    int beforeThreats = calculateThreatPotential(board, side);
-    int afterThreats = calculateThreatPotential(tempBoard, side);
-    score += (afterThreats - beforeThreats) * 10;
+    score += threatPotentialDelta(ownBefore, emptyBefore, ownAfter, emptyAfter) * 10;
 
 
     // Bonus for pushing opponent marbles off the edge
-    if (move.pushCount > 0) {
-        score += 50 * move.pushCount;
+    if (move.pushCount() > 0) {
+        score += 50 * move.pushCount();
     }
 
     // Bonus for inline moves (usually more powerful)
-    if (move.isInline) {
+    if (move.isInline()) {
         score += 20;
     }
 
     // Bonus for moves that go away from the edge if we're already in danger
     if (beforeDanger > 0) {
-        score += (beforeDanger - afterDanger) * 20;
+        score -= dangerDelta * 20;
     }
 
     return score;
 }
 
-int AbaloneAI::calculateThreatPotential(const Board& board, Occupant side) {
-    int threatScore = 0;
+// calculateCohesion(after) - calculateCohesion(before). Cohesion counts ordered
+// pairs of adjacent own marbles, so only pairs with a marble that arrived or
+// left change; pairs among the arrivals (or among the departures) count twice.
+int AbaloneAI::cohesionDelta(uint64_t ownBefore, uint64_t ownAfter) {
+    uint64_t arrived = ownAfter & ~ownBefore;
+    uint64_t left = ownBefore & ~ownAfter;
+    int delta = 0;
+    for (uint64_t bits = arrived; bits; bits &= bits - 1) {
+        uint64_t adjacent = Board::s_neighborMasks[Board::lowestSetBit(bits)];
+        delta += 2 * Board::popcount(adjacent & ownAfter) - Board::popcount(adjacent & arrived);
+    }
+    for (uint64_t bits = left; bits; bits &= bits - 1) {
+        uint64_t adjacent = Board::s_neighborMasks[Board::lowestSetBit(bits)];
+        delta -= 2 * Board::popcount(adjacent & ownBefore) - Board::popcount(adjacent & left);
+    }
+    return delta;
+}
 
-    // Check for potential threats in each direction
-    for (int i = 0; i < Board::NUM_CELLS; i++) {
-        if (board.occupant[i] == side) {
-            for (int d = 0; d < Board::NUM_DIRECTIONS; d++) {
-                int neighbor = board.neighbors[i][d];
-                if (neighbor >= 0 && board.occupant[neighbor] == Occupant::EMPTY) {
-                    // Check if the next cell is an opponent
-                    int nextNeighbor = board.neighbors[neighbor][d];
-                    if (nextNeighbor >= 0 && board.occupant[nextNeighbor] != side) {
-                        threatScore++;
-                    }
-                }
+// calculateThreatPotential(after) - calculateThreatPotential(before). A threat
+// is a line x, x+d, x+2d with x own, x+d empty and x+2d on the board and not
+// own. Read along a line of three a, b, c, both directions together give
+// empty(b) & (own(a) ^ own(c)), so only the lines through a changed cell matter.
+int AbaloneAI::threatPotentialDelta(uint64_t ownBefore, uint64_t emptyBefore, uint64_t ownAfter,
+                                    uint64_t emptyAfter) {
+    uint64_t changed = (ownBefore ^ ownAfter) | (emptyBefore ^ emptyAfter);
+    auto lineThreats = [](uint64_t own, uint64_t empty, const std::array<int, 3>& line) {
+        return static_cast<int>((empty >> line[1]) & ((own >> line[0]) ^ (own >> line[2])) & 1ULL);
+    };
+
+    int delta = 0;
+    for (uint64_t bits = changed; bits; bits &= bits - 1) {
+        int cell = Board::lowestSetBit(bits);
+        uint64_t earlierChanged = changed & ((1ULL << cell) - 1);
+        const BoardGeometry::CellLines& through = BoardGeometry::LINES_OF_THREE_THROUGH[cell];
+        for (int k = 0; k < through.count; k++) {
+            int l = through.lines[k];
+            // A line through several changed cells is counted at the first of them.
+            if (BoardGeometry::LINE_OF_THREE_MASKS[l] & earlierChanged) {
+                continue;
             }
+            const auto& line = BoardGeometry::LINES_OF_THREE[l];
+            delta += lineThreats(ownAfter, emptyAfter, line) - lineThreats(ownBefore, emptyBefore, line);
         }
     }
+    return delta;
+}
+
+int AbaloneAI::calculateThreatPotential(const Board& board, Occupant side) {
+    int threatScore = 0;
+    uint64_t own = board.getBitboard(side);
+    uint64_t empty = board.getEmptyBitboard();
+    uint64_t notOwn = Board::BOARD_MASK & ~own;
+
+    // A threat is an own marble whose neighbor in direction d is empty and
+    // whose next cell along d is on the board and not ours.
+    for (int d = 0; d < Board::NUM_DIRECTIONS; d++) {
+        int back = Board::oppositeDirection(d);
+        uint64_t emptyBeforeTarget = empty & Board::shiftBitboard(notOwn, back);
+        threatScore += Board::popcount(own & Board::shiftBitboard(emptyBeforeTarget, back));
+    }
 
     return threatScore;
 }
@@ -237,59 +359,44 @@ int AbaloneAI::calculateThreatPotential(const Board& board, Occupant side) {
 // Calculate the cohesion of a group of marbles
 int AbaloneAI::calculateCohesion(const Board& board, Occupant side) {
     int cohesion = 0;
-    for (int i = 0; i < Board::NUM_CELLS; i++) {
-        if (board.occupant[i] == side) {
-            for (int d = 0; d < Board::NUM_DIRECTIONS; d++) {
-                int neighbor = board.neighbors[i][d];
-                if (neighbor >= 0 && board.occupant[neighbor] == side)
-                    cohesion++;
-            }
-        }
+    uint64_t own = board.getBitboard(side);
+    // Each (marble, direction) pair with a friendly neighbor counts once.
+    for (int d = 0; d < Board::NUM_DIRECTIONS; d++) {
+        cohesion += Board::popcount(own & Board::shiftBitboard(own, d));
     }
     return cohesion;
 }
 
 // Calculate the number of marbles on the edge of the board
 int AbaloneAI::calculateEdgeDanger(const Board& board, Occupant side) {
-    int edgeCount = 0;
-    for (int i = 0; i < Board::NUM_CELLS; i++) {
-        if (board.occupant[i] == side) {
-            bool onEdge = false;
-            for (int d = 0; d < Board::NUM_DIRECTIONS; d++) {
-                if (board.neighbors[i][d] < 0) {  // neighbor off-board
-                    onEdge = true;
-                    break;
-                }
-            }
-            if (onEdge)
-                edgeCount++;
-        }
-    }
-    return edgeCount;
+    return Board::popcount(board.getBitboard(side) & Board::s_edgeMask);
 }
 
 bool AbaloneAI::isTimeUp() {
-    if (timeLimit <= 0)
-        return false;
-    auto now = std::chrono::high_resolution_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime).count();
-    bool result = elapsed >= timeLimit;
+    bool result = timeManager.hardLimitReached();
 
     if (result) {
-        std::lock_guard<std::mutex> lock(timeoutMutex);
-        timeoutOccurred = true;
+        timeoutOccurred.store(true, std::memory_order_relaxed);
+        stopSearch.store(true, std::memory_order_relaxed);
     }
 
     return result;
 }
 
-// Helper method to update killer moves
-void AbaloneAI::updateKillerMove(const Move& move, int depth) {
+void AbaloneAI::pollTime(SearchWorker& worker) {
+    if (--worker.nodesUntilTimeCheck > 0) {
+        return;
+    }
+    worker.nodesUntilTimeCheck = std::max(1, options.timeCheckNodes);
+    isTimeUp();
+}
 
-    std::lock_guard<std::mutex> lock(killerMovesMutex);
+// Helper method to update killer moves
+void AbaloneAI::updateKillerMove(SearchWorker& worker, const Move& move, int depth) {
+    auto& killerMoves = worker.killerMoves;
 
     // Don't store captures as killer moves (they're already prioritized)
-    if (move.pushCount > 0)
+    if (move.pushCount() > 0)
         return;
 
     // Don't store the move if it's already the first killer move
@@ -304,31 +411,55 @@ void AbaloneAI::updateKillerMove(const Move& move, int depth) {
 }
 
 // Helper function to check if a move is a killer move
-bool AbaloneAI::isKillerMove(const Move& move, int depth) const {
-    std::lock_guard<std::mutex> lock(killerMovesMutex);
-    return (depth < killerMoves.size() &&
+bool AbaloneAI::isKillerMove(const SearchWorker& worker, const Move& move, int depth) {
+    const auto& killerMoves = worker.killerMoves;
+    return (depth < static_cast<int>(killerMoves.size()) &&
         (killerMoves[depth][0] == move || killerMoves[depth][1] == move));
 }
 
 // Helper function to sort moves based on their evaluation
-void AbaloneAI::orderMoves(std::vector<Move>& moves, const Board& board, Occupant side, const Move& ttMove, int depth) {
+void AbaloneAI::updateHistory(SearchWorker& worker, Occupant side, const Move& move, const Move& previousMove,
+                              int depth) {
+    if (move.pushCount() > 0)
+        return;
+
+    int sideIndex = (side == Occupant::BLACK) ? 0 : 1;
+    auto& history = worker.history[sideIndex];
+    int& entry = history[historyIndex(move)];
+    entry += depth * depth;
+    if (entry >= HISTORY_MAX) {
+        for (int& score : history) {
+            score /= 2;
+        }
+    }
+
+    if (!previousMove.isNull()) {
+        worker.counterMoves[sideIndex][historyIndex(previousMove)] = move;
+    }
+}
+
+void AbaloneAI::orderMoves(const SearchWorker& worker, MoveList& moves, const Board& board, Occupant side,
+                           const Move& ttMove, int depth, const Move& previousMove, bool evaluateQuietMoves) {
     // Define a struct to hold moves and their scores
     struct ScoredMove {
         Move move;
         int score;
 
-        ScoredMove(const Move& m, int s) : move(m), score(s) {}
-
         // For sorting in descending order (highest score first)
         bool operator<(const ScoredMove& other) const {
             return score > other.score;
         }
     };
 
-    std::vector<ScoredMove> scoredMoves;
+    std::array<ScoredMove, MoveList::CAPACITY> scoredMoves;
+
+    int sideIndex = (side == Occupant::BLACK) ? 0 : 1;
+    const auto& history = worker.history[sideIndex];
+    Move counterMove = previousMove.isNull() ? Move() : worker.counterMoves[sideIndex][historyIndex(previousMove)];
 
     // Score each move
-    for (const Move& move : moves) {
+    for (int i = 0; i < moves.size(); i++) {
+        const Move& move = moves[i];
         int moveScore = 0;
 
         // 1. Highest priority: Transposition table move
@@ -336,46 +467,83 @@ void AbaloneAI::orderMoves(std::vector<Move>& moves, const Board& board, Occupan
             moveScore = 100000;  // Very high score
         }
         // 2. Second priority: Killer moves
-        else if (isKillerMove(move, depth)) {
+        else if (isKillerMove(worker, move, depth)) {
             moveScore = 10000;  // High score, but lower than TT move
 
             // First killer move gets higher priority than second
-            if (move == killerMoves[depth][0]) {
+            if (move == worker.killerMoves[depth][0]) {
                 moveScore += 1000;
             }
         }
-        // 3. Third priority: Move evaluation heuristic
-        else {
+        // 3. Full move evaluation where the subtree is large enough to pay for it
+        else if (evaluateQuietMoves) {
             moveScore = evaluateMove(board, move, side);
         }
+        // 4. Otherwise cheap keys: countermove, pushes, then history
+        else if (move == counterMove) {
+            moveScore = 9000;
+        }
+        else if (move.pushCount() > 0) {
+            moveScore = 5000 + 1000 * move.pushCount();
+        }
+        else {
+            moveScore = history[historyIndex(move)];
+        }
 
-        scoredMoves.push_back(ScoredMove(move, moveScore));
+        scoredMoves[i] = { move, moveScore };
     }
 
     // Sort moves by score
-    std::sort(scoredMoves.begin(), scoredMoves.end());
+    std::sort(scoredMoves.begin(), scoredMoves.begin() + moves.size());
 
-    // Update the original vector with sorted moves
-    for (size_t i = 0; i < moves.size(); i++) {
+    // Update the original list with sorted moves
+    for (int i = 0; i < moves.size(); i++) {
         moves[i] = scoredMoves[i].move;
     }
 }
 
-int AbaloneAI::minimax(Board& board, int depth, int alpha, int beta, bool maximizingPlayer, float gameProgress) {
+int AbaloneAI::searchThreadCount(const SearchOptions& searchOptions) {
+    if (searchOptions.threads > 0) {
+        return searchOptions.threads;
+    }
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
 
-    {
-        std::lock_guard<std::mutex> lock(timeoutMutex);
-        if (timeoutOccurred) {
-            timeoutOccurred = true;
-            return evaluatePosition(board, gameProgress);
-        }
+bool AbaloneAI::nullMoveAllowed(const Board& board, const EvalFeatures& features) const {
+    // Near the end, or one capture away from losing, passing can be a real
+    // advantage (zugzwang-like positions), so the null move proves nothing.
+    if (phaseOf(features.marbles[0] + features.marbles[1]) == PHASE_MAX) {
+        return false;
     }
+    return board.countMarbles(Occupant::BLACK) - 1 > ENDGAME && board.countMarbles(Occupant::WHITE) - 1 > ENDGAME;
+}
 
-    {
-        std::lock_guard<std::mutex> lock(pruningMutex);
-        if (depth == 0) {
-            return evaluatePosition(board, gameProgress);
-        }
+int AbaloneAI::lateMoveReduction(const Move& move, int moveIndex, int depth, bool isKiller) const {
+    // Pushes and killers are never reduced, nor is the first (TT) move.
+    if (!options.lateMoveReductions || depth < options.lmrMinDepth ||
+        moveIndex < std::max(1, options.lmrFullDepthMoves) || isKiller || move.pushCount() > 0) {
+        return 0;
+    }
+
+    // Late side-steps (and single marble moves) rarely change anything tactically: one more ply off.
+    int reduction = 1;
+    if (!move.isInline() && moveIndex >= 3 * options.lmrFullDepthMoves) {
+        reduction++;
+    }
+    return std::min(reduction, depth - 2);
+}
+
+int AbaloneAI::minimax(SearchWorker& worker, Board& board, int depth, int alpha, int beta, bool maximizingPlayer,
+                       bool allowNullMove, const Move& previousMove) {
+    pollTime(worker);
+
+    if (searchAborted()) {
+        worker.stats.nodes++;
+        return evaluateFeatures(board.nextToMove, worker.features());
+    }
+
+    if (depth == 0) {
+        return quiescence(worker, board, alpha, beta, maximizingPlayer, 0);
     }
 
     // Transposition Table Check
@@ -385,9 +553,10 @@ int AbaloneAI::minimax(Board& board, int depth, int alpha, int beta, bool maximi
     int score;
     MoveType moveType;
 
-    if (transpositionTable.probeEntry(board, depth, score, moveType, bestMove)) {
-        std::lock_guard<std::mutex> lock(ttMutex);
-
+    uint64_t positionKey = board.hash();
+    worker.stats.ttProbes++;
+    if (transpositionTable.probeEntry(positionKey, depth, score, moveType, bestMove)) {
+        worker.stats.ttHits++;
         if (moveType == MoveType::EXACT) {
             return score;
         }
@@ -398,17 +567,36 @@ int AbaloneAI::minimax(Board& board, int depth, int alpha, int beta, bool maximi
             beta = std::min(beta, score);
         }
         if (alpha >= beta) {
-            {
-                std::lock_guard<std::mutex> lock(pruningMutex);
-                pruningCount++;
-            }
+            worker.stats.cutoffs++;
             return score;
         }
     }
 
+    // Null-move pruning, tried only in null-window (non-PV) nodes: if we are
+    // still past the bound after letting the opponent move twice, confirm with
+    // a reduced search of our own moves and cut off.
+    if (allowNullMove && options.nullMovePruning && depth >= options.nullMoveMinDepth &&
+        static_cast<long long>(beta) - alpha == 1 && nullMoveAllowed(board, worker.features())) {
+        int reducedDepth = std::max(0, depth - 1 - options.nullMoveReduction);
+
+        board.makeNullMove();
+        int nullScore = minimax(worker, board, reducedDepth, alpha, beta, !maximizingPlayer, false, Move());
+        board.makeNullMove();
+
+        bool failsHigh = maximizingPlayer ? nullScore >= beta : nullScore <= alpha;
+        if (failsHigh && !searchAborted()) {
+            int verifyScore = minimax(worker, board, std::max(1, depth - options.nullMoveReduction), alpha, beta,
+                                      maximizingPlayer, false, previousMove);
+            if (maximizingPlayer ? verifyScore >= beta : verifyScore <= alpha) {
+                worker.stats.nullCutoffs++;
+                return verifyScore;
+            }
+        }
+    }
+
     // Generate possible moves
     Occupant currentPlayer = maximizingPlayer ? Occupant::BLACK : Occupant::WHITE;
-    std::vector<Move> possibleMoves = board.generateMoves(currentPlayer);
+    MoveList possibleMoves = board.generateMoves(currentPlayer);
 
     if (possibleMoves.empty()) {
         return maximizingPlayer ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
@@ -416,8 +604,9 @@ int AbaloneAI::minimax(Board& board, int depth, int alpha, int beta, bool maximi
 
     // Move ordering
     Move ttBestMove;
-    bool hasTTMove = transpositionTable.getBestMove(board, ttBestMove);
-    orderMoves(possibleMoves, board, currentPlayer, hasTTMove ? ttBestMove : Move(), depth);
+    bool hasTTMove = transpositionTable.getBestMove(positionKey, ttBestMove);
+    orderMoves(worker, possibleMoves, board, currentPlayer, hasTTMove ? ttBestMove : Move(), depth, previousMove,
+               depth >= EVALUATE_MOVE_DEPTH);
 
     MoveType entryType = MoveType::UPPERBOUND;
     Move localBestMove;
@@ -425,25 +614,49 @@ int AbaloneAI::minimax(Board& board, int depth, int alpha, int beta, bool maximi
 
     // PVS: Principal Variation Search
     bool firstMove = true;
+    int moveIndex = 0;
     for (const Move& move : possibleMoves) {
-        Board tempBoard = board;
-        tempBoard.applyMove(move);
+        int reduction = lateMoveReduction(move, moveIndex++, depth, isKillerMove(worker, move, depth));
+
+        UndoInfo undo = makeSearchMove(worker, board, move);
 
         int eval;
         if (firstMove) {
             // Full window search for the first move
-            eval = minimax(tempBoard, depth - 1, alpha, beta, !maximizingPlayer, gameProgress);
+            eval = minimax(worker, board, depth - 1, alpha, beta, !maximizingPlayer, true, move);
             firstMove = false;
         }
         else {
-            // Null window search (PVS)
-            eval = minimax(tempBoard, depth - 1, alpha, alpha + 1, !maximizingPlayer, gameProgress);
-            if (eval > alpha && eval < beta) {
-                // Full re-search if null-window fails
-                eval = minimax(tempBoard, depth - 1, alpha, beta, !maximizingPlayer, gameProgress);
+            // Null window around the bound this side is trying to improve:
+            // alpha for the maximizer, beta for the minimizer.
+            int nullAlpha = maximizingPlayer ? alpha : beta - 1;
+            int nullBeta = maximizingPlayer ? alpha + 1 : beta;
+
+            // Late move reduction: a shallower null-window probe first; only a
+            // move that beats the bound there is searched at full depth.
+            bool improves = true;
+            if (reduction > 0) {
+                worker.stats.reductions++;
+                eval = minimax(worker, board, depth - 1 - reduction, nullAlpha, nullBeta, !maximizingPlayer,
+                               true, move);
+                improves = maximizingPlayer ? eval > alpha : eval < beta;
+                if (improves) {
+                    worker.stats.reSearches++;
+                }
+            }
+
+            if (improves) {
+                // Null window search (PVS)
+                eval = minimax(worker, board, depth - 1, nullAlpha, nullBeta, !maximizingPlayer, true, move);
+                if (eval > alpha && eval < beta) {
+                    // Full re-search if null-window fails
+                    eval = minimax(worker, board, depth - 1, alpha, beta, !maximizingPlayer, true, move);
+                }
             }
         }
 
+        unmakeSearchMove(worker, board, undo);
+
         if (maximizingPlayer) {
             if (eval > value) {
                 value = eval;
@@ -460,15 +673,18 @@ int AbaloneAI::minimax(Board& board, int depth, int alpha, int beta, bool maximi
         }
 
         if (beta <= alpha) {
-            {
-                std::lock_guard<std::mutex> lock(pruningMutex);
-                pruningCount++;
-            }
-            updateKillerMove(move, depth);  // Update killer move on cutoff
+            worker.stats.cutoffs++;
+            updateKillerMove(worker, move, depth);  // Update killer move on cutoff
+            updateHistory(worker, currentPlayer, move, previousMove, depth);
             break;
         }
     }
 
+    // A search cut short returns a guess; keep it out of the table.
+    if (searchAborted()) {
+        return value;
+    }
+
     // Store in transposition table
     if (value <= origAlpha) {
         entryType = MoveType::UPPERBOUND;
@@ -479,53 +695,192 @@ int AbaloneAI::minimax(Board& board, int depth, int alpha, int beta, bool maximi
     else {
         entryType = MoveType::EXACT;
     }
-    {
-        std::lock_guard<std::mutex> lock(ttMutex);
-        transpositionTable.storeEntry(board, depth, value, entryType, localBestMove);
+    // The table is lock-free; no synchronisation is needed here.
+    transpositionTable.storeEntry(positionKey, depth, value, entryType, localBestMove);
+
+    return value;
+}
+
+int AbaloneAI::quiescence(SearchWorker& worker, Board& board, int alpha, int beta, bool maximizingPlayer, int qdepth) {
+    pollTime(worker);
+    worker.stats.nodes++;
+    if (qdepth > 0) {
+        worker.stats.qnodes++;
+    }
+
+    // Stand pat: the side to move is never forced to push.
+    int standPat = evaluateFeatures(board.nextToMove, worker.features());
+    if (searchAborted() || qdepth >= MAX_QUIESCENCE_DEPTH) {
+        return standPat;
+    }
+    if (maximizingPlayer) {
+        if (standPat >= beta) {
+            return standPat;
+        }
+        alpha = std::max(alpha, standPat);
+    }
+    else {
+        if (standPat <= alpha) {
+            return standPat;
+        }
+        beta = std::min(beta, standPat);
+    }
+
+    // The most a single capture is worth in this phase (marbles weigh more towards the end).
+    int captureValue = weightsFor(worker.features()).decisiveMarble;
+
+    // Delta pruning: if even a capture cannot bring the score back into the
+    // window, no push will.
+    if ((maximizingPlayer && standPat + captureValue + DELTA_MARGIN <= alpha) ||
+        (!maximizingPlayer && standPat - captureValue - DELTA_MARGIN >= beta)) {
+        return standPat;
+    }
+
+    Occupant currentPlayer = maximizingPlayer ? Occupant::BLACK : Occupant::WHITE;
+    bool quietPushesAllowed = qdepth < QUIESCENCE_PUSH_PLIES;
+    bool quietPushesUseful = maximizingPlayer ? standPat + DELTA_MARGIN > alpha
+                                              : standPat - DELTA_MARGIN < beta;
+
+    // Captures first, then the other pushes.
+    MoveList captures;
+    MoveList pushes;
+    for (const Move& move : board.generateMoves(currentPlayer)) {
+        if (move.pushCount() == 0) {
+            continue;
+        }
+        if (board.isCaptureMove(move)) {
+            captures.push_back(move);
+        }
+        else if (quietPushesAllowed && quietPushesUseful && board.isPushMove(move, currentPlayer)) {
+            pushes.push_back(move);
+        }
+    }
+
+    int value = standPat;
+    for (const MoveList* list : { &captures, &pushes }) {
+        for (const Move& move : *list) {
+            UndoInfo undo = makeSearchMove(worker, board, move);
+            int eval = quiescence(worker, board, alpha, beta, !maximizingPlayer, qdepth + 1);
+            unmakeSearchMove(worker, board, undo);
+
+            if (maximizingPlayer) {
+                value = std::max(value, eval);
+                alpha = std::max(alpha, eval);
+            }
+            else {
+                value = std::min(value, eval);
+                beta = std::min(beta, eval);
+            }
+            if (beta <= alpha) {
+                worker.stats.cutoffs++;
+                return value;
+            }
+        }
     }
 
     return value;
 }
 
-AbaloneAI::AbaloneAI(int depth, int timeLimitMs, size_t ttSizeInMB)
-    : maxDepth(depth), nodesEvaluated(0), timeLimit(timeLimitMs),
-    timeoutOccurred(false), transpositionTable(ttSizeInMB),
-    killerMoves(depth + 1) {
-    pruningCount = 0;
+AbaloneAI::AbaloneAI(int depth, int timeLimitMs, size_t ttSizeInMB, const SearchOptions& searchOptions)
+    : maxDepth(depth), options(searchOptions),
+    workers(searchThreadCount(searchOptions)), helperPool(searchThreadCount(searchOptions) - 1),
+    transpositionTable(ttSizeInMB), evalCache(EVAL_CACHE_SIZE_KB) {
+    timeControl.moveTimeMs = timeLimitMs;
+    for (auto& worker : workers) {
+        worker.clear();
+    }
+}
+
+AbaloneAI::~AbaloneAI() {
+    stopSearching();
+    stopPondering();
 }
 
-std::pair<Move, int> AbaloneAI::findBestMove(Board& board, float gameProgress) {
-    nodesEvaluated = 0;
-    timeoutOccurred = false;
-    startTime = std::chrono::high_resolution_clock::now();
+void AbaloneAI::newGame() {
+    stopSearching();
+    stopPondering();
+    ponderState = DeepeningState();
+    transpositionTable.clearTable();
+    evalCache.clear();
+    for (auto& worker : workers) {
+        worker.clear();
+    }
+    totalStats = SearchStats();
+}
+
+int AbaloneAI::searchRoot(SearchWorker& worker, Board& board, const MoveList& rootMoves, int depth, int alpha,
+                          int beta, bool maximizingPlayer, Move& bestMove) {
+    int bestScore = maximizingPlayer ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+    bestMove = rootMoves[0];
+    worker.rootMoveNodes.fill(0);
 
-    transpositionTable.incrementAge();
-    killerMoves = std::vector<std::array<Move, MAX_KILLER_MOVES>>(maxDepth + 1);
+    // Every position below is evaluated from these, updated move by move.
+    worker.featureTop = 0;
+    worker.featureStack[0] = computeFeatures(board);
+
+    for (int i = 0; i < rootMoves.size(); i++) {
+        if (isTimeUp() || searchAborted()) {
+            break;
+        }
+
+        const Move& move = rootMoves[i];
+        long long nodesBefore = worker.stats.nodes;
+        UndoInfo undo = makeSearchMove(worker, board, move);
+        int score;
+        if (i == 0) {
+            score = minimax(worker, board, depth - 1, alpha, beta, !maximizingPlayer, true, move);
+        }
+        else {
+            // Principal variation search: the later moves only have to be shown no
+            // better than the best so far; one that is gets a full-window search.
+            int nullAlpha = maximizingPlayer ? alpha : clampScore(static_cast<long long>(beta) - 1);
+            int nullBeta = maximizingPlayer ? clampScore(static_cast<long long>(alpha) + 1) : beta;
+            score = minimax(worker, board, depth - 1, nullAlpha, nullBeta, !maximizingPlayer, true, move);
+            bool improves = maximizingPlayer ? score > alpha : score < beta;
+            if (improves && !searchAborted()) {
+                score = minimax(worker, board, depth - 1, alpha, beta, !maximizingPlayer, true, move);
+            }
+        }
+        unmakeSearchMove(worker, board, undo);
+        worker.rootMoveNodes[i] = worker.stats.nodes - nodesBefore;
 
+        if ((maximizingPlayer && score > bestScore) || (!maximizingPlayer && score < bestScore)) {
+            bestScore = score;
+            bestMove = move;
+        }
+        if (maximizingPlayer) {
+            alpha = std::max(alpha, score);
+        }
+        else {
+            beta = std::min(beta, score);
+        }
+        // Past the other side of an aspiration window: the caller widens it and searches again.
+        if (alpha >= beta) {
+            break;
+        }
+    }
+
+    return bestScore;
+}
+
+bool AbaloneAI::selectRootMoveByRules(const Board& board, float gameProgress, const MoveList& possibleMoves,
+                                      std::pair<Move, int>& selected) {
     Occupant currentPlayer = board.nextToMove;
     bool maximizingPlayer = (currentPlayer == Occupant::BLACK);
 
     if (gameProgress == 0.0f && currentPlayer == Occupant::BLACK) {
-        std::vector<Move> allMoves = board.generateMoves(currentPlayer);
-        if (!allMoves.empty()) {
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<int> dist(0, static_cast<int>(allMoves.size() - 1));
-            int randomIndex = dist(gen);
-            Move randomMove = allMoves[randomIndex];
-            return std::make_pair(randomMove, 0);
-        }
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::uniform_int_distribution<int> dist(0, static_cast<int>(possibleMoves.size() - 1));
+        int randomIndex = dist(gen);
+        Move randomMove = possibleMoves[randomIndex];
+        selected = std::make_pair(randomMove, 0);
+        return true;
     }
 
     // Check if we're in endgame with tied scores
-    int blackMarbles = 0;
-    int whiteMarbles = 0;
-    for (int i = 0; i < Board::NUM_CELLS; i++) {
-        if (board.occupant[i] == Occupant::BLACK)
-            blackMarbles++;
-        else if (board.occupant[i] == Occupant::WHITE)
-            whiteMarbles++;
-    }
+    int blackMarbles = board.countMarbles(Occupant::BLACK);
+    int whiteMarbles = board.countMarbles(Occupant::WHITE);
 
     // Calculate if scores are roughly tied
     bool scoresTied = blackMarbles == whiteMarbles;
@@ -557,12 +912,6 @@ std::pair<Move, int> AbaloneAI::findBestMove(Board& board, float gameProgress) {
         isCloseToLosing = (whiteMarbles - 1) == ENDGAME;
     }
 
-    std::vector<Move> possibleMoves = board.generateMoves(currentPlayer);
-
-    if (possibleMoves.empty()) {
-        return std::make_pair(Move(), 0);
-    }
-
     Move bestTempMove;
     int bestTempScore = maximizingPlayer ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
     bool foundBestMove = false;
@@ -574,19 +923,26 @@ std::pair<Move, int> AbaloneAI::findBestMove(Board& board, float gameProgress) {
         }
     }
 
-    int currentScore = evaluatePosition(board, gameProgress);
+    int currentScore = evaluatePosition(board);
 
-    for (const auto& move : possibleMoves) {
-        for (int idx : move.marbleIndices) {
-            if (endangeredMarbles.count(idx)) {
+    // Static scores of every child position, computed once for the filters below.
+    std::vector<int> childScores(possibleMoves.size());
+    evaluateChildren(workers[0], board, possibleMoves, childScores.data());
+
+    for (int i = 0; i < possibleMoves.size(); i++) {
+        const Move& move = possibleMoves[i];
+        std::array<int, Move::MAX_GROUP_SIZE> group;
+        int groupSize = move.getMarbles(group);
+        for (int g = 0; g < groupSize; g++) {
+            if (endangeredMarbles.count(group[g])) {
                 // Simulate the move
                 Board tempBoard = board;
                 tempBoard.applyMove(move);
-                int tempScore = evaluatePosition(tempBoard, gameProgress);
+                int tempScore = childScores[i];
                 // Check if the marble is now safer
                 bool stillInDanger = false;
-                for (int marble : move.marbleIndices) {
-                    if (tempBoard.isMarbleInDanger(marble, currentPlayer)) {
+                for (int m = 0; m < groupSize; m++) {
+                    if (tempBoard.isMarbleInDanger(group[m], currentPlayer)) {
                         stillInDanger = true;
                         break;
                     }
@@ -626,24 +982,20 @@ std::pair<Move, int> AbaloneAI::findBestMove(Board& board, float gameProgress) {
 
     if (isCloseToLosing && foundBestMove) {
         std::cout << "Close to losing: Returning best defensive move\n";
-        return std::make_pair(bestTempMove, bestTempScore);
+        selected = std::make_pair(bestTempMove, bestTempScore);
+        return true;
     }
 
-    for (const auto& move : possibleMoves) {
+    for (int i = 0; i < possibleMoves.size(); i++) {
+        const Move& move = possibleMoves[i];
         if (board.isPushMove(move, currentPlayer)) {
             // Evaluate the move by simulating it first
             Board tempBoard = board;
             tempBoard.applyMove(move);
-            int tempScore = evaluatePosition(tempBoard, gameProgress);
-
-            int tempBlackMarbles = 0;
-            int tempWhiteMarbles = 0;
-            for (int i = 0; i < Board::NUM_CELLS; i++) {
-                if (tempBoard.occupant[i] == Occupant::BLACK)
-                    tempBlackMarbles++;
-                else if (tempBoard.occupant[i] == Occupant::WHITE)
-                    tempWhiteMarbles++;
-            }
+            int tempScore = childScores[i];
+
+            int tempBlackMarbles = tempBoard.countMarbles(Occupant::BLACK);
+            int tempWhiteMarbles = tempBoard.countMarbles(Occupant::WHITE);
             
             bool isScoringMove = false;
             // Check if the move is beneficial
@@ -676,7 +1028,8 @@ std::pair<Move, int> AbaloneAI::findBestMove(Board& board, float gameProgress) {
     // If we found a good move (defensive or push), return it
     if (foundBestMove) {
         std::cout << "Selected best move with score: " << bestTempScore << std::endl;
-        return std::make_pair(bestTempMove, bestTempScore);
+        selected = std::make_pair(bestTempMove, bestTempScore);
+        return true;
     }
 
     // If we're in endgame with tied scores, prioritize pushing moves immediately
@@ -689,22 +1042,16 @@ std::pair<Move, int> AbaloneAI::findBestMove(Board& board, float gameProgress) {
             std::cout << "Endgame with tied scores: Prioritizing push moves" << std::endl;
         }
         // Look for pushing moves
-        for (const auto& move : possibleMoves) {
+        for (int i = 0; i < possibleMoves.size(); i++) {
+            const Move& move = possibleMoves[i];
             if (board.isPushMove(move, currentPlayer)) {
                 // Calculate rough score for logging purposes
                 Board tempBoard = board;
                 tempBoard.applyMove(move);
-                int tempScore = evaluatePosition(tempBoard, gameProgress);
-                int currentScore = evaluatePosition(board, gameProgress);
-
-                int tempBlackMarbles = 0;
-                int tempWhiteMarbles = 0;
-                for (int i = 0; i < Board::NUM_CELLS; i++) {
-                    if (tempBoard.occupant[i] == Occupant::BLACK)
-                        tempBlackMarbles++;
-                    else if (tempBoard.occupant[i] == Occupant::WHITE)
-                        tempWhiteMarbles++;
-                }
+                int tempScore = childScores[i];
+
+                int tempBlackMarbles = tempBoard.countMarbles(Occupant::BLACK);
+                int tempWhiteMarbles = tempBoard.countMarbles(Occupant::WHITE);
 
                 bool isScoringMove = false;
                 // Check if the move is beneficial
@@ -717,78 +1064,127 @@ std::pair<Move, int> AbaloneAI::findBestMove(Board& board, float gameProgress) {
                 
                 if (isScoringMove) {
                     std::cout << "Directly selecting push move with score: " << tempScore << std::endl;
-                    return std::make_pair(move, tempScore);
+                    selected = std::make_pair(move, tempScore);
+                    return true;
                 }
             }
         }
     }
 
-    std::cout << "Regular move evaluation" << std::endl;
+    return false;
+}
 
-    Move ttBestMove;
-    bool hasTTMove = transpositionTable.getBestMove(board, ttBestMove);
-    orderMoves(possibleMoves, board, currentPlayer, hasTTMove ? ttBestMove : Move(), maxDepth);
+void AbaloneAI::beginMove(const TimeControl& control, bool newMove) {
+    timeoutOccurred = false;
+    stopSearch = false;
+    timeManager.start(control);
+
+    // One age per move: entries from every iteration of this move stay current.
+    if (newMove) {
+        transpositionTable.incrementAge();
+        for (auto& worker : workers) {
+            worker.prepareSearch();
+        }
+    }
+}
 
-    Move bestMove = possibleMoves[0];
-    int bestScore = maximizingPlayer ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+int AbaloneAI::searchIteration(Board& board, const MoveList& rootMoves, int depth, int alpha, int beta,
+                               Move& bestMove) {
+    bool maximizingPlayer = (board.nextToMove == Occupant::BLACK);
+    lastSearchStats = SearchStats();
+    for (auto& worker : workers) {
+        worker.stats = SearchStats();
+    }
+    stopSearch = false;
+    // Set before stopSearch by stopPondering, so a stop never gets lost in the reset above.
+    if (stopRequested) {
+        stopSearch = true;
+    }
 
-    // Sets thread count to 8 
-    // ======================
-    // WARNING!!! THIS IS SYSTEM SPECIFIC
-    // ======================
-    int threadCount = std::min(8, (int)possibleMoves.size());
-    std::vector<std::future<std::pair<int, Move>>> futures;
+    // Lazy SMP: helper threads search the full root move list at staggered
+    // depths and share what they learn through the transposition table. Only
+    // the main thread's search decides the move.
+    const Board rootSnapshot = board;
+    helperPool.start([&](int id) {
+        Board helperBoard = rootSnapshot;
+        for (int helperDepth = depth + (id & 1); helperDepth < MAX_PLY && !searchAborted(); helperDepth++) {
+            Move helperBest;
+            searchRoot(workers[id], helperBoard, rootMoves, helperDepth, std::numeric_limits<int>::min(),
+                       std::numeric_limits<int>::max(), maximizingPlayer, helperBest);
+        }
+    });
 
-    for (int i = 0; i < threadCount; ++i) {
-        futures.push_back(std::async(std::launch::async, [&, i]() {
-            if (timeoutOccurred) return std::make_pair(0, Move()); // Stop early
+    int bestScore = searchRoot(workers[0], board, rootMoves, depth, alpha, beta, maximizingPlayer, bestMove);
 
-            const Move& move = possibleMoves[i];
-            Board tempBoard = board;
-            tempBoard.applyMove(move);
-            int score = this->minimax(tempBoard, maxDepth - 1,
-                std::numeric_limits<int>::min(),
-                std::numeric_limits<int>::max(),
-                !maximizingPlayer,
-                gameProgress);
-                
-            return std::make_pair(score, move);
-            }));
-    }
-
-    //  // Changes thread count
-    //     std::vector<std::future<std::pair<int, Move>>> futures;
-    //     int threadCount = std::min((int)possibleMoves.size(), static_cast<int>(std::thread::hardware_concurrency()));
-
-    //     for (const Move& move : possibleMoves) {
-    //         futures.push_back(std::async(std::launch::async, [&board, move, this, maximizingPlayer]() {
-    //             Board tempBoard = board;
-    //             tempBoard.applyMove(move);
-    //             int score = this->minimax(tempBoard, maxDepth - 1,
-    //                                       std::numeric_limits<int>::min(),
-    //                                       std::numeric_limits<int>::max(),
-    //                                       !maximizingPlayer);
-    //             return std::make_pair(score, move);
-    //         }));
-    //     }
-
-    for (auto& f : futures) {
-        if (isTimeUp()) {
-            std::lock_guard<std::mutex> lock(timeoutMutex);
-            timeoutOccurred = true;
-            break;
-        }
-        auto [score, move] = f.get();
-        if ((maximizingPlayer && score > bestScore) || (!maximizingPlayer && score < bestScore)) {
-            bestScore = score;
-            bestMove = move;
+    // Completed or not, the main search is over: stop the helpers, then it is
+    // safe to read what every worker counted.
+    stopSearch = true;
+    helperPool.wait();
+
+    for (const auto& worker : workers) {
+        lastSearchStats.add(worker.stats);
+    }
+    totalStats.add(lastSearchStats);
+
+    return bestScore;
+}
+
+void AbaloneAI::reorderRootMoves(MoveList& rootMoves, const Move& bestMove) {
+    // The best move first, then the others by the size of their subtrees in the
+    // last iteration: a move that took long to refute is likely to be close.
+    const auto& nodes = workers[0].rootMoveNodes;
+    std::array<int, MoveList::CAPACITY> order;
+    for (int i = 0; i < rootMoves.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.begin() + rootMoves.size(), [&](int a, int b) {
+        bool aBest = rootMoves[a] == bestMove;
+        bool bBest = rootMoves[b] == bestMove;
+        if (aBest != bBest) {
+            return aBest;
         }
+        return nodes[a] > nodes[b];
+    });
+
+    MoveList reordered;
+    for (int i = 0; i < rootMoves.size(); i++) {
+        reordered.push_back(rootMoves[order[i]]);
     }
+    rootMoves = reordered;
+}
+
+std::pair<Move, int> AbaloneAI::findBestMove(Board& board, float gameProgress) {
+    stopSearching();
+    stopPondering();
+    beginMove(timeControl, true);
+
+    Occupant currentPlayer = board.nextToMove;
+    MoveList possibleMoves = board.generateMoves(currentPlayer);
+    if (possibleMoves.empty()) {
+        return std::make_pair(Move(), 0);
+    }
+
+    std::pair<Move, int> selected;
+    if (selectRootMoveByRules(board, gameProgress, possibleMoves, selected)) {
+        return selected;
+    }
+
+    std::cout << "Regular move evaluation" << std::endl;
+
+    Move ttBestMove;
+    bool hasTTMove = transpositionTable.getBestMove(board.hash(), ttBestMove);
+    orderMoves(workers[0], possibleMoves, board, currentPlayer, hasTTMove ? ttBestMove : Move(), maxDepth, Move(),
+               true);
+
+    Move bestMove;
+    int bestScore = searchIteration(board, possibleMoves, maxDepth, std::numeric_limits<int>::min(),
+                                    std::numeric_limits<int>::max(), bestMove);
 
-    auto end = std::chrono::high_resolution_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - startTime).count();
+    auto elapsed = timeManager.elapsedMs();
 
-    std::cout << "Nodes evaluated: " << nodesEvaluated << std::endl;
+    std::cout << "Nodes evaluated: " << lastSearchStats.nodes << std::endl;
+    std::cout << "Quiescence nodes: " << lastSearchStats.qnodes << std::endl;
+    std::cout << "Cutoffs: " << lastSearchStats.cutoffs << std::endl;
     std::cout << "Time taken: " << elapsed << " ms" << std::endl;
     std::cout << "Timeout occurred: " << (timeoutOccurred ? "Yes" : "No") << std::endl;
     std::cout << "Best move score: " << bestScore << std::endl;
@@ -796,20 +1192,120 @@ std::pair<Move, int> AbaloneAI::findBestMove(Board& board, float gameProgress) {
     return std::make_pair(bestMove, bestScore);
 }
 
+void AbaloneAI::deepen(Board& board, int maxSearchDepth, DeepeningState& state, bool reportProgress, bool log) {
+    for (int depth = state.completedDepth + 1; depth <= maxSearchDepth; depth++) {
+        // An iteration started past the soft limit would hardly ever finish.
+        if (depth > 1 && timeManager.softLimitReached()) {
+            if (log) {
+                std::cout << "Soft time limit reached after " << timeManager.elapsedMs() << " ms. Stopping search."
+                          << std::endl;
+            }
+            break;
+        }
+        if (log) {
+            std::cout << "Searching at depth " << depth << "..." << std::endl;
+        }
+
+        // Aspiration window around the previous score; a fail low or high widens
+        // that side and searches again, eventually with the full window.
+        int alpha = std::numeric_limits<int>::min();
+        int beta = std::numeric_limits<int>::max();
+        long long delta = ASPIRATION_WINDOW;
+        bool aspirate = state.completedDepth > 0 && depth >= ASPIRATION_MIN_DEPTH &&
+                        state.bestScore != std::numeric_limits<int>::min() &&
+                        state.bestScore != std::numeric_limits<int>::max();
+        if (aspirate) {
+            alpha = clampScore(static_cast<long long>(state.bestScore) - delta);
+            beta = clampScore(static_cast<long long>(state.bestScore) + delta);
+        }
+
+        int64_t depthStart = timeManager.elapsedMs();
+        long long depthNodes = 0;
+        Move iterationMove;
+        int iterationScore;
+        bool interrupted = false;
+        while (true) {
+            iterationScore = searchIteration(board, state.rootMoves, depth, alpha, beta, iterationMove);
+            depthNodes += lastSearchStats.nodes;
+            interrupted = timeoutOccurred || stopRequested;
+            if (interrupted) {
+                break;
+            }
+            bool failLow = iterationScore <= alpha && alpha != std::numeric_limits<int>::min();
+            bool failHigh = iterationScore >= beta && beta != std::numeric_limits<int>::max();
+            if (!failLow && !failHigh) {
+                break;
+            }
+            delta *= 4;
+            if (failLow) {
+                alpha = clampScore(static_cast<long long>(state.bestScore) - delta);
+            }
+            else {
+                beta = clampScore(static_cast<long long>(state.bestScore) + delta);
+            }
+            if (log) {
+                std::cout << "Aspiration " << (failLow ? "fail low" : "fail high") << " at depth " << depth
+                          << " (" << iterationScore << "), widening" << std::endl;
+            }
+        }
+
+        // Time-to-depth: nodes and time of this iteration and time since the search began.
+        if (log) {
+            std::cout << "Depth " << depth << ": " << depthNodes << " nodes, "
+                      << timeManager.elapsedMs() - depthStart << " ms (" << timeManager.elapsedMs() << " ms total)"
+                      << std::endl;
+        }
+
+        if (!interrupted) {
+            state.bestMove = iterationMove;
+            state.bestScore = iterationScore;
+            state.completedDepth = depth;
+            reorderRootMoves(state.rootMoves, state.bestMove);
+            if (log) {
+                std::cout << "Completed depth " << depth << std::endl;
+            }
+
+            if (reportProgress && progressCallback) {
+                SearchProgress progress;
+                progress.depth = depth;
+                progress.score = state.bestScore;
+                progress.bestMove = state.bestMove;
+                progress.nodes = totalStats.nodes;
+                progress.elapsedMs = timeManager.elapsedMs();
+                progressCallback(progress);
+            }
+        }
+        else {
+            state.interruptedMove = iterationMove;
+            if (log && timeoutOccurred) {
+                std::cout << "Timeout at depth " << depth << ", using previous result" << std::endl;
+            }
+            else if (log) {
+                std::cout << "Search stopped at depth " << depth << std::endl;
+            }
+            break;
+        }
+    }
+}
+
 std::pair<Move, int> AbaloneAI::findBestMoveIterativeDeepening(Board& board, int maxSearchDepth, int moveCount, int totalMoves) {
+    stopSearching();
+    stopRequested = false;
+    return iterativeDeepening(board, maxSearchDepth, moveCount, totalMoves);
+}
+
+std::pair<Move, int> AbaloneAI::iterativeDeepening(Board& board, int maxSearchDepth, int moveCount, int totalMoves) {
     // Clamp the maximum search depth to the object's maxDepth.
-    maxSearchDepth = std::min(maxSearchDepth, this->maxDepth);
+    maxSearchDepth = std::min(std::min(maxSearchDepth, this->maxDepth), MAX_PLY - 1);
 
-    nodesEvaluated = 0;
-    timeoutOccurred = false;
-    startTime = std::chrono::high_resolution_clock::now();
+    // Pondering ends here (if startSearch has not ended it already); if it was
+    // searching this very position, carry on from where it got to (this is still
+    // the same move, so the table is not aged again).
+    stopPondering();
+    bool ponderHit = ponderState.completedDepth > 0 && ponderHash == board.hash();
 
-    Move bestMove;
-    int bestScore = 0;
-    bool foundMove = false;
-
-    // Reset killer moves for each new search
-    killerMoves = std::vector<std::array<Move, MAX_KILLER_MOVES>>(maxSearchDepth + 1);
+    totalStats = SearchStats();
+    beginMove(timeControl, !ponderHit);
 
     std::cout << "Move count: " << moveCount << std::endl;
     std::cout << "Total moves: " << totalMoves << std::endl;
@@ -817,55 +1313,176 @@ std::pair<Move, int> AbaloneAI::findBestMoveIterativeDeepening(Board& board, int
     float gameProgress = static_cast<float>(moveCount) / totalMoves;
     gameProgress = std::min(1.0f, std::max(0.0f, gameProgress));
 
-    for (int depth = 1; depth <= maxSearchDepth; depth++) {
-        std::cout << "Searching at depth " << depth << "..." << std::endl;
-
-        // Check if total elapsed time exceeds the time limit
-        auto now = std::chrono::high_resolution_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime).count();
-        if (elapsed >= timeLimit) {
-            std::cout << "Total time limit exceeded. Stopping search." << std::endl;
-            break;
-        }
-
-        // Adjust remaining time for this depth
-        int remainingTime = timeLimit - elapsed;
-        int originalTimeLimit = timeLimit;
-        timeLimit = remainingTime;
-
-        int originalMaxDepth = maxDepth;
-        maxDepth = depth;
+    Occupant currentPlayer = board.nextToMove;
+    MoveList rootMoves = board.generateMoves(currentPlayer);
+    if (rootMoves.empty()) {
+        return std::make_pair(Move(), 0);
+    }
 
-        auto result = findBestMove(board, gameProgress);
+    // The rule-based choices do not depend on depth: settle them once.
+    std::pair<Move, int> selected;
+    if (selectRootMoveByRules(board, gameProgress, rootMoves, selected)) {
+        return selected;
+    }
 
-        // Restore original time limit and max depth.
-        timeLimit = originalTimeLimit;
-        maxDepth = originalMaxDepth;
+    std::cout << "Regular move evaluation" << std::endl;
 
-        if (!timeoutOccurred) {
-            bestMove = result.first;
-            bestScore = result.second;
-            foundMove = true;
-            std::cout << "Completed depth " << depth << std::endl;
-        }
-        else {
-            std::cout << "Timeout at depth " << depth << ", using previous result" << std::endl;
-            break;
-        }
+    DeepeningState state;
+    if (ponderHit) {
+        state = ponderState;
+        std::cout << "Ponder hit: depth " << state.completedDepth << " already searched" << std::endl;
     }
+    else {
+        Move ttBestMove;
+        bool hasTTMove = transpositionTable.getBestMove(board.hash(), ttBestMove);
+        orderMoves(workers[0], rootMoves, board, currentPlayer, hasTTMove ? ttBestMove : Move(), 1, Move(), true);
+        state.rootMoves = rootMoves;
+        state.interruptedMove = rootMoves[0];
+    }
+    ponderState = DeepeningState();
+
+    deepen(board, maxSearchDepth, state, true, true);
 
-    if (!foundMove) {
-        std::cout << "Warning: No complete depth search finished. Using 1-ply search." << std::endl;
-        maxDepth = 1;
-        auto result = findBestMove(board, gameProgress);
-        bestMove = result.first;
-        bestScore = result.second;
+    Move bestMove = state.bestMove;
+    int bestScore = state.bestScore;
+    if (state.completedDepth == 0) {
+        // Not even depth 1 finished: the best root move seen before time ran out.
+        std::cout << "Warning: No complete depth search finished. Using the interrupted search." << std::endl;
+        bestMove = state.interruptedMove;
     }
 
     std::cout << "Transposition table usage: " << transpositionTable.getUsage() << "%" << std::endl;
-    // std::cout << "TT hit rate: " << transpositionTable.getHitRate() << "%" << std::endl;
-    // std::cout << "Pruning count: " << pruningCount << std::endl;
+    std::cout << "Total nodes: " << totalStats.nodes << std::endl;
+    std::cout << "Late move reductions: " << totalStats.reductions << " (" << totalStats.reSearches
+              << " re-searched), null-move cutoffs: " << totalStats.nullCutoffs << std::endl;
+    if (totalStats.ttProbes > 0) {
+        std::cout << "Transposition table hit rate: "
+                  << (100.0 * totalStats.ttHits / totalStats.ttProbes) << "%" << std::endl;
+    }
+    EvalCache::Stats evalStats = evalCache.getStats();
+    std::cout << "Evaluation cache hit rate: " << evalStats.hitRate() << "% (" << evalStats.hits << " of "
+              << evalStats.probes << ")" << std::endl;
     std::cout << "Game progress: " << gameProgress << std::endl;
 
     return std::make_pair(bestMove, bestScore);
 }
+
+std::pair<Move, int> AbaloneAI::analysePosition(const Board& board, int depth, int timeLimitMs) {
+    stopSearching();
+    stopPondering();
+    stopRequested = false;
+    depth = std::max(1, std::min(depth, MAX_PLY - 1));
+
+    Board root = board;
+    MoveList rootMoves = root.generateMoves(root.nextToMove);
+    if (rootMoves.empty()) {
+        return std::make_pair(Move(), 0);
+    }
+
+    TimeControl control;
+    control.moveTimeMs = timeLimitMs;
+    totalStats = SearchStats();
+    beginMove(control, true);
+
+    Move ttBestMove;
+    bool hasTTMove = transpositionTable.getBestMove(root.hash(), ttBestMove);
+    orderMoves(workers[0], rootMoves, root, root.nextToMove, hasTTMove ? ttBestMove : Move(), 1, Move(), true);
+    DeepeningState state;
+    state.rootMoves = rootMoves;
+    state.interruptedMove = rootMoves[0];
+
+    deepen(root, depth, state, false, false);
+    if (state.completedDepth == 0) {
+        return std::make_pair(state.interruptedMove, 0);
+    }
+    return std::make_pair(state.bestMove, state.bestScore);
+}
+
+Move AbaloneAI::startPondering(const Board& board, int maxSearchDepth) {
+    stopSearching();
+    stopPondering();
+    maxSearchDepth = std::min(std::min(maxSearchDepth, this->maxDepth), MAX_PLY - 1);
+
+    // The reply our own search expects; without one, the opponent's position
+    // itself is searched, which still fills the table for every reply.
+    ponderBoard = board;
+    Move predicted;
+    if (transpositionTable.getBestMove(board.hash(), predicted) && board.isLegalMove(predicted)) {
+        ponderBoard.makeMove(predicted);
+    }
+    else {
+        predicted = Move();
+    }
+
+    MoveList rootMoves = ponderBoard.generateMoves(ponderBoard.nextToMove);
+    if (rootMoves.empty()) {
+        return predicted;
+    }
+
+    // No time limit: pondering lasts until stopPondering or maxSearchDepth.
+    stopRequested = false;
+    beginMove(TimeControl(), true);
+
+    Move ttBestMove;
+    bool hasTTMove = transpositionTable.getBestMove(ponderBoard.hash(), ttBestMove);
+    orderMoves(workers[0], rootMoves, ponderBoard, ponderBoard.nextToMove, hasTTMove ? ttBestMove : Move(), 1,
+               predicted, true);
+
+    ponderHash = ponderBoard.hash();
+    ponderState = DeepeningState();
+    ponderState.rootMoves = rootMoves;
+    ponderState.interruptedMove = rootMoves[0];
+
+    std::cout << "Pondering " << (predicted.isNull() ? std::string("all replies")
+                                                     : Board::moveToNotation(predicted, board.nextToMove))
+              << std::endl;
+    ponderThread = std::thread([this, maxSearchDepth]() {
+        deepen(ponderBoard, maxSearchDepth, ponderState, false, true);
+    });
+    return predicted;
+}
+
+bool AbaloneAI::stopPondering() {
+    if (!ponderThread.joinable()) {
+        return false;
+    }
+    stopRequested = true;
+    stopSearch = true;
+    ponderThread.join();
+    stopRequested = false;
+    return true;
+}
+
+bool AbaloneAI::isPonderingOn(const Board& board) const {
+    return ponderThread.joinable() && ponderHash == board.hash();
+}
+
+void AbaloneAI::startSearch(const Board& board, int maxSearchDepth, int moveCount, int totalMoves) {
+    stopSearching();
+    stopPondering();
+
+    // Cleared here rather than on the search thread: a stopSearching right after
+    // this call must not be undone by the thread starting late.
+    stopRequested = false;
+    searchDone = false;
+    searchBoard = board;
+    searchThread = std::thread([this, maxSearchDepth, moveCount, totalMoves]() {
+        searchResult = iterativeDeepening(searchBoard, maxSearchDepth, moveCount, totalMoves);
+        searchDone = true;
+    });
+}
+
+std::pair<Move, int> AbaloneAI::waitForSearch() {
+    if (searchThread.joinable()) {
+        searchThread.join();
+    }
+    return searchResult;
+}
+
+std::pair<Move, int> AbaloneAI::stopSearching() {
+    if (searchThread.joinable()) {
+        stopRequested = true;
+        stopSearch = true;
+    }
+    return waitForSearch();
+}
@@ -2,59 +2,273 @@
 #define ABALONE_AI_H
 
 #include "Board.h"
+#include "EvalCache.h"
+#include "EvalFeatures.h"
 #include "TranspositionTable.h"
+#include "SearchThreadPool.h"
+#include "TimeManager.h"
+#include <atomic>
 #include <chrono>
+#include <functional>
 #include <utility>
-#include <mutex>
 #include <thread>
-#include <mutex>
-#include <chrono>
 #include <vector>
 #include <array>
+#include <algorithm>
+#include <limits>
+
+// Tunable search settings, fixed for the lifetime of an AbaloneAI.
+struct SearchOptions {
+    // Total search threads (the main thread plus Lazy SMP helpers).
+    // 0 uses std::thread::hardware_concurrency().
+    int threads = 0;
+
+    // Late move reductions: quiet moves ordered after the first
+    // 'lmrFullDepthMoves' are searched 1-2 plies shallower (and re-searched at
+    // full depth if they turn out to matter). Only at depth >= lmrMinDepth.
+    bool lateMoveReductions = true;
+    int lmrFullDepthMoves = 4;
+    int lmrMinDepth = 3;
+
+    // Null-move pruning: let the opponent move twice at depth - 1 - nullMoveReduction;
+    // if we are still above beta, confirm with a reduced search before cutting off.
+    // Never used near the end of the game, where passing could be a real advantage.
+    bool nullMovePruning = true;
+    int nullMoveReduction = 2;
+    int nullMoveMinDepth = 3;
+
+    // Every search thread looks at the clock once per this many nodes.
+    int timeCheckNodes = 1024;
+};
+
+// Reported after every completed iteration of a search for a move (not while pondering).
+struct SearchProgress {
+    int depth = 0;
+    int score = 0;
+    Move bestMove;
+    long long nodes = 0;      // searched for this move so far
+    int64_t elapsedMs = 0;    // since the search for this move began
+};
 
 
 class AbaloneAI {
 private:
-    // Maximum search depth
-    int maxDepth;
-    // Number of positions evaluated
-    int nodesEvaluated;
-    // Time limit for search in milliseconds
-    int timeLimit;
-    // Start time of search
-    std::chrono::time_point<std::chrono::high_resolution_clock> startTime;
-    // Indicates if search was terminated due to time limit
-    bool timeoutOccurred;
-
-    mutable std::mutex evalMutex;
-    mutable std::mutex ttMutex;
-    mutable std::mutex timeoutMutex;
-    mutable std::mutex pruningMutex;
-    mutable std::mutex killerMovesMutex;
+    // regression_check.cpp checks the move scorer and the incremental features directly.
+    friend struct RegressionProbe;
 
     // Piece value
     static const int MARBLE_VALUE = 100;
 
-    TranspositionTable transpositionTable;
+    // Deepest search (in plies from the root) any thread may start.
+    static constexpr int MAX_PLY = 64;
 
-    //count the number of times pruning occurs
-    int pruningCount = 0;
+    // Quiescence search: captures are followed up to MAX_QUIESCENCE_DEPTH plies past
+    // the nominal depth, other pushes only for the first QUIESCENCE_PUSH_PLIES of them.
+    static constexpr int MAX_QUIESCENCE_DEPTH = 6;
+    static constexpr int QUIESCENCE_PUSH_PLIES = 2;
+    // Largest positional swing a single push is assumed to cause (delta pruning).
+    static constexpr int DELTA_MARGIN = 150;
 
-    // Killer move heuristic - stores two killer moves per depth
+    // Killer move heuristic - stores two killer moves per remaining depth (up to MAX_PLY)
     static constexpr int MAX_KILLER_MOVES = 2;
-    std::vector<std::array<Move, MAX_KILLER_MOVES>> killerMoves;
+
+    // Butterfly history: one counter per (group, direction) regardless of the
+    // position, i.e. anchor x axis x length x direction, kept per side.
+    static constexpr int HISTORY_SIZE = Board::NUM_CELLS * 3 * Move::MAX_GROUP_SIZE * Board::NUM_DIRECTIONS;
+    // History scores stay below this (the whole table is halved when one reaches it),
+    // which keeps quiet moves ordered after pushes.
+    static constexpr int HISTORY_MAX = 4096;
+    // Quiet moves at nodes with at least this much depth left (and at the root)
+    // are ordered with the full evaluateMove instead of the history table.
+    static constexpr int EVALUATE_MOVE_DEPTH = 4;
+
+    // Aspiration windows: from ASPIRATION_MIN_DEPTH on, an iteration first searches
+    // previous score +/- ASPIRATION_WINDOW, widening (x4) whichever side fails.
+    static constexpr int ASPIRATION_MIN_DEPTH = 3;
+    static constexpr int ASPIRATION_WINDOW = 50;
+
+    static int clampScore(long long score) {
+        return static_cast<int>(std::max<long long>(std::numeric_limits<int>::min(),
+                                                    std::min<long long>(std::numeric_limits<int>::max(), score)));
+    }
+
+    // Static evaluations are cached here, keyed by position hash.
+    static constexpr size_t EVAL_CACHE_SIZE_KB = 512;
+
+    static int historyIndex(const Move& move) {
+        return ((move.anchor() * 3 + move.axis() - 1) * Move::MAX_GROUP_SIZE + move.length() - 1)
+            * Board::NUM_DIRECTIONS + move.direction();
+    }
+
+    // Counters gathered while searching.
+    struct SearchStats {
+        long long nodes = 0;      // positions evaluated
+        long long qnodes = 0;     // of those, positions reached in quiescence search
+        long long cutoffs = 0;    // beta cutoffs, including ones taken from the table
+        long long ttProbes = 0;
+        long long ttHits = 0;
+        long long reductions = 0;     // moves searched with a late move reduction
+        long long reSearches = 0;     // of those, moves searched again at full depth
+        long long nullCutoffs = 0;    // cutoffs confirmed after a null move
+
+        void add(const SearchStats& other) {
+            nodes += other.nodes;
+            qnodes += other.qnodes;
+            cutoffs += other.cutoffs;
+            ttProbes += other.ttProbes;
+            ttHits += other.ttHits;
+            reductions += other.reductions;
+            reSearches += other.reSearches;
+            nullCutoffs += other.nullCutoffs;
+        }
+    };
+
+    // Everything one search thread writes while it searches. Each thread owns
+    // exactly one worker (index 0 is the main thread), so the search itself
+    // needs no locks; the counters are merged once the threads are done.
+    struct SearchWorker {
+        std::array<std::array<Move, MAX_KILLER_MOVES>, MAX_PLY + 1> killerMoves;
+        // [side][historyIndex(move)]: how often the quiet move caused a cutoff, weighted by depth.
+        std::array<std::array<int, HISTORY_SIZE>, 2> history;
+        // [side][historyIndex(opponent's last move)]: the quiet reply that last refuted it.
+        std::array<std::array<Move, HISTORY_SIZE>, 2> counterMoves;
+        SearchStats stats;
+        // Nodes left before this thread next looks at the clock.
+        int nodesUntilTimeCheck = 0;
+
+        // Nodes searched below each root move (by index) in this worker's last searchRoot.
+        std::array<long long, MoveList::CAPACITY> rootMoveNodes;
+
+        // Features of every position on the current search path; the top entry
+        // belongs to the position being searched.
+        std::array<EvalFeatures, MAX_PLY + MAX_QUIESCENCE_DEPTH + 1> featureStack;
+        int featureTop = 0;
+
+        // evaluateChildren's scratch space (too large for a thread's stack): the
+        // children missing from the evaluation cache, their keys, move indices and features.
+        std::array<std::array<uint64_t, 2>, MoveList::CAPACITY> childPositions{};
+        std::array<uint64_t, MoveList::CAPACITY> childKeys{};
+        std::array<int, MoveList::CAPACITY> childMoves{};
+        std::array<EvalFeatures, MoveList::CAPACITY> childFeatures{};
+
+        const EvalFeatures& features() const { return featureStack[featureTop]; }
+
+        // Before each search: killers and counters start over, history is aged.
+        void prepareSearch() {
+            for (auto& killers : killerMoves) {
+                killers = std::array<Move, MAX_KILLER_MOVES>();
+            }
+            for (auto& table : history) {
+                for (int& score : table) {
+                    score /= 2;
+                }
+            }
+            stats = SearchStats();
+        }
+
+        void clear() {
+            prepareSearch();
+            for (auto& table : history) {
+                table.fill(0);
+            }
+            for (auto& table : counterMoves) {
+                table.fill(Move());
+            }
+        }
+    };
+
+    // Progress of an iterative deepening search; pondering hands its state over
+    // to the real search on a ponder hit.
+    struct DeepeningState {
+        MoveList rootMoves;      // ordered by the last completed iteration
+        Move bestMove;
+        int bestScore = 0;
+        int completedDepth = 0;
+        Move interruptedMove;    // best move of an iteration that did not finish
+    };
+
+    // Maximum search depth
+    int maxDepth;
+    // Time allowed per move (the constructor's timeLimitMs, or setTimeControl)
+    TimeControl timeControl;
+    // Soft and hard limits of the move being searched
+    TimeManager timeManager;
+
+    // Raised when the time limit runs out; the interrupted iteration is discarded.
+    std::atomic<bool> timeoutOccurred{ false };
+
+    // Polled by every search thread: raised on timeout and when the main thread
+    // has finished its search, telling the Lazy SMP helpers to abandon theirs.
+    std::atomic<bool> stopSearch{ false };
+
+    SearchOptions options;
+
+    // One per search thread; workers[0] belongs to the thread calling findBestMove.
+    std::vector<SearchWorker> workers;
+
+    // Lazy SMP helpers, started once and parked between searches.
+    SearchThreadPool helperPool;
+
+    // Pondering: a background iterative deepening search of the position we
+    // expect after the opponent's reply, stopped by stopPondering.
+    std::thread ponderThread;
+    std::atomic<bool> stopRequested{ false };
+    Board ponderBoard;
+    uint64_t ponderHash = 0;
+    DeepeningState ponderState;
+
+    // Background search started by startSearch. stopRequested is shared with
+    // pondering; only one of the two runs at a time.
+    std::thread searchThread;
+    std::atomic<bool> searchDone{ true };
+    Board searchBoard;
+    std::pair<Move, int> searchResult;
+
+    // Called by the searching thread itself; see setProgressCallback.
+    std::function<void(const SearchProgress&)> progressCallback;
+
+    TranspositionTable transpositionTable;
+
+    EvalCache evalCache;
+
+    // Totals merged from the workers after each findBestMove / iterative deepening run.
+    SearchStats lastSearchStats;
+    SearchStats totalStats;
 
     // Helper method to update killer moves
-    void updateKillerMove(const Move& move, int depth);
+    static void updateKillerMove(SearchWorker& worker, const Move& move, int depth);
 
     // Helper function to check if a move is a killer move
-    bool isKillerMove(const Move& move, int depth) const;
+    static bool isKillerMove(const SearchWorker& worker, const Move& move, int depth);
+
+    // Rewards a quiet move that caused a beta cutoff in the history and countermove tables.
+    static void updateHistory(SearchWorker& worker, Occupant side, const Move& move, const Move& previousMove,
+                              int depth);
 
     /**
      * Evaluates the current board position from BLACK's perspective.
      * Higher scores are better for BLACK, lower scores for WHITE.
+     * Weights taper from midgame to endgame values as marbles leave the board,
+     * so the score depends on the position alone.
      */
-    int evaluatePosition(const Board& board, float gameProgress);
+    int evaluatePosition(const Board& board);
+
+    // evaluatePosition from already computed features of a position with 'toMove' to move.
+    int evaluateFeatures(Occupant toMove, const EvalFeatures& features);
+
+    EvalFeatures computeFeatures(const Board& board);
+
+    // Scores the position after each of 'moves' (the side to move is left as is, like
+    // Board::applyMove), computing their features together with EvalBatch.
+    void evaluateChildren(SearchWorker& worker, const Board& board, const MoveList& moves, int* scores);
+
+    // Applies the change from the 'before' to the 'after' bitboards (a few cells) to 'features'.
+    static void updateFeatures(EvalFeatures& features, const std::array<uint64_t, 2>& before,
+                               const std::array<uint64_t, 2>& after);
+
+    // Board::makeMove / unmakeMove for the search: also push and pop the worker's features.
+    UndoInfo makeSearchMove(SearchWorker& worker, Board& board, const Move& move);
+    void unmakeSearchMove(SearchWorker& worker, Board& board, const UndoInfo& undo);
 
     /**
      * Calculates group cohesion for the given side.
@@ -74,24 +288,113 @@ private:
     int calculateThreatPotential(const Board& board, Occupant side);
 
     /**
-     * Checks if the time limit has been exceeded.
+     * Checks if the hard time limit has been reached, and if so stops the search.
      */
     bool isTimeUp();
 
+    // isTimeUp once every SearchOptions::timeCheckNodes calls by this worker.
+    void pollTime(SearchWorker& worker);
+
+    /**
+     * True once this search should unwind: the time limit ran out or, for helper
+     * threads, the main thread is done. Results of an aborted search are not stored.
+     */
+    bool searchAborted() const { return stopSearch.load(std::memory_order_relaxed); }
+
+    // Number of search threads to use (resolves SearchOptions::threads == 0).
+    static int searchThreadCount(const SearchOptions& searchOptions);
+
     /**
-     * The minimax algorithm with alpha-beta pruning.
+     * Alpha-beta over the already ordered root moves within (alpha, beta). Returns
+     * the best score and sets 'bestMove'. Used by the main thread and by every Lazy
+     * SMP helper; a score outside the window only bounds the true one.
      */
-    int minimax(Board& board, int depth, int alpha, int beta, bool maximizingPlayer, float gameProgress);
+    int searchRoot(SearchWorker& worker, Board& board, const MoveList& rootMoves, int depth, int alpha, int beta,
+                   bool maximizingPlayer, Move& bestMove);
+
+    // Start of a move: clears the stop flags and starts the clock with 'control'.
+    // For a new move (not a ponder hit) it also ages the transposition table and
+    // prepares the workers; that happens once per move, not per iteration.
+    void beginMove(const TimeControl& control, bool newMove);
+
+
+    // Runs iterations completedDepth + 1 .. maxSearchDepth on 'board', until the
+    // time manager, stopPondering or stopSearching ends the search. With
+    // 'reportProgress', every completed iteration goes to the progress callback;
+    // with 'log', each iteration is also written to std::cout.
+    void deepen(Board& board, int maxSearchDepth, DeepeningState& state, bool reportProgress, bool log);
+
+    // findBestMoveIterativeDeepening without resetting stopRequested, so that a
+    // stopSearching issued before the background thread gets here still counts.
+    std::pair<Move, int> iterativeDeepening(Board& board, int maxSearchDepth, int moveCount, int totalMoves);
+
+    // One root search at 'depth' by the main thread, with the Lazy SMP helpers
+    // running alongside. Fills lastSearchStats and adds it to totalStats.
+    int searchIteration(Board& board, const MoveList& rootMoves, int depth, int alpha, int beta, Move& bestMove);
+
+    // After an iteration: 'bestMove' first, the rest by their subtree sizes in it.
+    void reorderRootMoves(MoveList& rootMoves, const Move& bestMove);
+
+    // The move chosen without searching (the opening move, a defensive move when
+    // close to losing, a capturing push, an endgame push), if any applies.
+    bool selectRootMoveByRules(const Board& board, float gameProgress, const MoveList& possibleMoves,
+                               std::pair<Move, int>& selected);
+
+    /**
+     * The minimax algorithm with alpha-beta pruning. 'allowNullMove' is false
+     * directly below a null move and inside its verification search;
+     * 'previousMove' is the move that led here (null after a null move).
+     */
+    int minimax(SearchWorker& worker, Board& board, int depth, int alpha, int beta, bool maximizingPlayer,
+                bool allowNullMove, const Move& previousMove);
+
+    // True when passing the turn is safe to use as a lower bound (not near the end of the game).
+    bool nullMoveAllowed(const Board& board, const EvalFeatures& features) const;
+
+    // Plies to take off the search of the 'moveIndex'-th ordered move, or 0.
+    int lateMoveReduction(const Move& move, int moveIndex, int depth, bool isKiller) const;
+
+    /**
+     * Resolves pushes at the leaves of the main search: the side to move may stand
+     * pat on the static evaluation or continue with a capturing (or, near the
+     * horizon, any pushing) move. 'qdepth' counts plies below the nominal depth.
+     */
+    int quiescence(SearchWorker& worker, Board& board, int alpha, int beta, bool maximizingPlayer, int qdepth);
 
     // Evaluate a move quickly for node ordering
     int evaluateMove(const Board& board, const Move& move, Occupant side);
 
-    // Order moves based on evaluation and TT move
-    void orderMoves(std::vector<Move>& moves, const Board& board, Occupant side, const Move& ttMove, int depth);
+    // Change in calculateCohesion / calculateThreatPotential between two
+    // bitboards that differ in a few cells, looking only at those cells.
+    static int cohesionDelta(uint64_t ownBefore, uint64_t ownAfter);
+    static int threatPotentialDelta(uint64_t ownBefore, uint64_t emptyBefore, uint64_t ownAfter, uint64_t emptyAfter);
+
+    // Order moves: TT move, killers, countermove, pushes, then quiet moves by history
+    // (or by evaluateMove when 'evaluateQuietMoves' is set, at the root and shallow plies).
+    void orderMoves(const SearchWorker& worker, MoveList& moves, const Board& board, Occupant side,
+                    const Move& ttMove, int depth, const Move& previousMove, bool evaluateQuietMoves);
 
 public:
     // Default parameters are specified only here.
-    AbaloneAI(int depth = 4, int timeLimitMs = 5000, size_t ttSizeInMB = 64);
+    AbaloneAI(int depth = 4, int timeLimitMs = 5000, size_t ttSizeInMB = 64,
+              const SearchOptions& searchOptions = SearchOptions());
+
+    ~AbaloneAI();
+
+    AbaloneAI(const AbaloneAI&) = delete;
+    AbaloneAI& operator=(const AbaloneAI&) = delete;
+
+    /**
+     * Forgets everything learned in the previous game (transposition table and
+     * move-ordering tables). The engine itself, including its threads, is meant
+     * to live for as many moves and games as the caller likes.
+     */
+    void newGame();
+
+    // Replaces the per-move time limit given to the constructor, e.g. with a
+    // game clock (remaining time, increment, moves to go). Applies from the next move.
+    void setTimeControl(const TimeControl& control) { timeControl = control; }
+    const TimeControl& getTimeControl() const { return timeControl; }
 
     /**
      * Finds the best move for the given board position.
@@ -99,11 +402,72 @@ public:
      */
     std::pair<Move, int> findBestMove(Board& board, float gameProgress);
 
+    // Static evaluation (as evaluatePosition) of 'count' positions given as
+    // bitboards, all with 'toMove' to move, computed with EvalBatch and not cached.
+    void evaluateBatch(const std::array<uint64_t, 2>* positions, int count, Occupant toMove, int* scores);
+
+    // Features and static evaluation of 'board' computed position by position
+    // (no EvalBatch, no cache): the reference the batch kernel is checked against.
+    EvalFeatures referenceFeatures(const Board& board) { return computeFeatures(board); }
+    int referenceEvaluation(const Board& board) { return evaluateFeatures(board.nextToMove, computeFeatures(board)); }
+
+    // Probes and hits of the evaluation cache since the engine was created (or newGame).
+    EvalCache::Stats getEvalCacheStats() const { return evalCache.getStats(); }
+
+    /**
+     * Starts pondering after our move: 'board' is the position with the opponent
+     * to move. If the transposition table predicts the reply, the position after
+     * it is searched in the background; otherwise the opponent's position itself
+     * (which warms the table for every reply). Returns the predicted reply (null
+     * if none). Any other call into the engine ends pondering first; a later
+     * findBestMoveIterativeDeepening on the pondered position continues its search.
+     */
+    Move startPondering(const Board& board, int maxSearchDepth = 10);
+
+    // Stops pondering, keeping what it found for a ponder hit. Returns false if not pondering.
+    bool stopPondering();
+
+    // True while pondering the position 'board' (i.e. the opponent played the predicted reply).
+    bool isPonderingOn(const Board& board) const;
+
     /**
      * Iterative deepening search.
      * Default max search depth is 10.
      */
     std::pair<Move, int> findBestMoveIterativeDeepening(Board& board, int maxSearchDepth = 10, int moveCount = 0, int totalMoves = 0);
+
+    /**
+     * Searches 'board' to 'depth' plies, or until 'timeLimitMs' runs out if it is
+     * positive, without the rule-based root moves and without logging: for
+     * analysing many positions. The transposition table is kept between calls.
+     * Ends pondering and any background search first.
+     */
+    std::pair<Move, int> analysePosition(const Board& board, int depth, int timeLimitMs = 0);
+
+    /**
+     * Runs findBestMoveIterativeDeepening on a copy of 'board' on the engine's
+     * own thread and returns at once; collect the move with waitForSearch or
+     * stopSearching. Ends pondering first. Any other search call (and newGame)
+     * stops a background search that is still running.
+     */
+    void startSearch(const Board& board, int maxSearchDepth = 10, int moveCount = 0, int totalMoves = 0);
+
+    // True while the background search is running.
+    bool isSearching() const { return searchThread.joinable() && !searchDone; }
+
+    // Waits for the background search to finish and returns its result (the last
+    // one if none is running).
+    std::pair<Move, int> waitForSearch();
+
+    // Makes the background search return as soon as possible with the best move
+    // of its last completed depth, and returns that.
+    std::pair<Move, int> stopSearching();
+
+    // Called with the depth, score, best move and node count after every completed
+    // iteration, on the searching thread. Set it between searches; empty disables it.
+    void setProgressCallback(std::function<void(const SearchProgress&)> callback) {
+        progressCallback = std::move(callback);
+    }
 };
 
 #endif // ABALONE_AI_H
\ No newline at end of file
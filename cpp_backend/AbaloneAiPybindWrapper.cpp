@@ -1,20 +1,205 @@
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iterator>
 #include <sstream>
+#include <stdexcept>
+#include <vector>
 #include "AbaloneAI.h"
 #include "Board.h"
 
+// NumPy boards for batch analysis. A position is either an int8[61] occupancy
+// row (0 empty, 1 black, 2 white, by cell index) or a uint64[2] pair of
+// bitboards (black, white); a batch is an (N, 61) or (N, 2) array. Bitboard
+// batches are read in place, occupancy rows are packed into bitboards once.
+using CellArray = pybind11::array_t<int8_t, pybind11::array::c_style | pybind11::array::forcecast>;
+using BitboardArray = pybind11::array_t<uint64_t, pybind11::array::c_style | pybind11::array::forcecast>;
+
+struct PositionBatch {
+    std::vector<std::array<uint64_t, 2>> packed;
+    BitboardArray bitboards;    // keeps a bitboard input alive
+    const std::array<uint64_t, 2>* data = nullptr;
+    int count = 0;
+};
+
+static_assert(sizeof(std::array<uint64_t, 2>) == 2 * sizeof(uint64_t), "bitboard pairs must be packed");
+
+static PositionBatch readPositions(const pybind11::array& positions) {
+    const char kind = positions.dtype().kind();
+    const pybind11::ssize_t itemSize = positions.dtype().itemsize();
+    const int width = (itemSize == 1) ? Board::NUM_CELLS : 2;
+    if ((kind != 'i' && kind != 'u') || (itemSize != 1 && itemSize != 8) || positions.ndim() < 1 ||
+        positions.ndim() > 2 || positions.shape(positions.ndim() - 1) != width) {
+        throw std::invalid_argument("positions must be int8 (N, 61) occupancy or uint64 (N, 2) bitboards");
+    }
+
+    PositionBatch batch;
+    batch.count = static_cast<int>(positions.ndim() == 2 ? positions.shape(0) : 1);
+    bool valid = true;
+    if (itemSize == 1) {
+        CellArray cells = CellArray::ensure(positions);
+        if (!cells) {
+            throw std::invalid_argument("positions could not be read as int8");
+        }
+        batch.packed.resize(batch.count);
+        const int8_t* data = cells.data();
+        pybind11::gil_scoped_release release;
+        for (int p = 0; p < batch.count && valid; p++) {
+            std::array<uint64_t, 2> bits = { 0, 0 };
+            const int8_t* row = data + static_cast<size_t>(p) * Board::NUM_CELLS;
+            for (int cell = 0; cell < Board::NUM_CELLS; cell++) {
+                if (row[cell] == static_cast<int8_t>(Occupant::BLACK)) {
+                    bits[0] |= 1ULL << cell;
+                }
+                else if (row[cell] == static_cast<int8_t>(Occupant::WHITE)) {
+                    bits[1] |= 1ULL << cell;
+                }
+                else if (row[cell] != static_cast<int8_t>(Occupant::EMPTY)) {
+                    valid = false;
+                }
+            }
+            batch.packed[p] = bits;
+        }
+        batch.data = batch.packed.data();
+    }
+    else {
+        batch.bitboards = BitboardArray::ensure(positions);
+        if (!batch.bitboards) {
+            throw std::invalid_argument("positions could not be read as uint64");
+        }
+        batch.data = reinterpret_cast<const std::array<uint64_t, 2>*>(batch.bitboards.data());
+        pybind11::gil_scoped_release release;
+        for (int p = 0; p < batch.count && valid; p++) {
+            const std::array<uint64_t, 2>& bits = batch.data[p];
+            valid = (bits[0] & bits[1]) == 0 && ((bits[0] | bits[1]) & ~Board::BOARD_MASK) == 0;
+        }
+    }
+    if (!valid) {
+        throw std::invalid_argument("positions contain an invalid cell value or overlapping bitboards");
+    }
+    return batch;
+}
+
+static Occupant sideFromString(const std::string& side) {
+    if (side == "b") {
+        return Occupant::BLACK;
+    }
+    if (side == "w") {
+        return Occupant::WHITE;
+    }
+    throw std::invalid_argument("to_move must be 'b' or 'w'");
+}
+
+// Number of legal moves of 'to_move' in each position, as int32[N].
+static pybind11::array_t<int32_t> legal_move_count_batch(const pybind11::array& positions,
+                                                         const std::string& to_move) {
+    Occupant side = sideFromString(to_move);
+    PositionBatch batch = readPositions(positions);
+    pybind11::array_t<int32_t> counts(batch.count);
+    int32_t* out = counts.mutable_data();
+    pybind11::gil_scoped_release release;
+    for (int p = 0; p < batch.count; p++) {
+        out[p] = Board(batch.data[p], side).generateMoves(side).size();
+    }
+    return counts;
+}
+
+// The legal moves of 'to_move' in every position as packed Move codes:
+// (codes uint32[M], offsets int64[N + 1]); position p's moves are
+// codes[offsets[p]:offsets[p + 1]].
+static pybind11::tuple generate_moves_batch(const pybind11::array& positions, const std::string& to_move) {
+    Occupant side = sideFromString(to_move);
+    PositionBatch batch = readPositions(positions);
+    std::vector<uint32_t> codes;
+    std::vector<int64_t> offsets(batch.count + 1, 0);
+    {
+        pybind11::gil_scoped_release release;
+        for (int p = 0; p < batch.count; p++) {
+            for (const Move& move : Board(batch.data[p], side).generateMoves(side)) {
+                codes.push_back(move.code);
+            }
+            offsets[p + 1] = static_cast<int64_t>(codes.size());
+        }
+    }
+    pybind11::array_t<uint32_t> codeArray(static_cast<pybind11::ssize_t>(codes.size()));
+    pybind11::array_t<int64_t> offsetArray(static_cast<pybind11::ssize_t>(offsets.size()));
+    std::memcpy(codeArray.mutable_data(), codes.data(), codes.size() * sizeof(uint32_t));
+    std::memcpy(offsetArray.mutable_data(), offsets.data(), offsets.size() * sizeof(int64_t));
+    return pybind11::make_tuple(codeArray, offsetArray);
+}
+
+// A packed Move code (as returned by generate_moves_batch) in document notation.
+// Raises ValueError for a code that is not a group of 1-3 cells on the board
+// moving in one of the six directions.
+static std::string move_notation(uint32_t code, const std::string& to_move) {
+    Occupant side = sideFromString(to_move);
+    Move move;
+    move.code = code;
+    const int* axesEnd = std::end(BoardGeometry::LINE_AXES);
+    bool valid = (code >> 16) == 0 && move.anchor() < Board::NUM_CELLS && move.length() >= 1 &&
+                 std::find(std::begin(BoardGeometry::LINE_AXES), axesEnd, move.axis()) != axesEnd &&
+                 move.direction() < Board::NUM_DIRECTIONS;
+    // Every marble of the group must be on the board.
+    for (int i = 1, cell = move.anchor(); valid && i < move.length(); i++) {
+        cell = Board::neighbors[cell][move.axis()];
+        valid = cell >= 0;
+    }
+    if (!valid) {
+        throw std::invalid_argument("Not a move code: " + std::to_string(code));
+    }
+    return Board::moveToNotation(move, side);
+}
+
 class AbaloneAIPybind {
 private:
+    // Deepest iteration requested from the engine (which also caps it at its own depth).
+    static constexpr int MAX_SEARCH_DEPTH = 10;
+
     AbaloneAI ai;
     Board board;
+    bool ponderEnabled;
+
+    // Moves played on 'board' since new_game / parse_board_state, for undo.
+    std::vector<std::pair<Move, UndoInfo>> history;
+    // Moves Black and White have made in the session game, and the limit per
+    // side, for the engine's game-progress rules (best_move). Unlike history,
+    // the counts survive a board loaded mid-game.
+    std::array<int, 2> movesMade{};
+    int movesPerTeam = 100;
+
+    // The last move best_move (or a search that did not play it) suggested, and the
+    // position it was for: playing it with apply_move starts pondering.
+    Move suggestedMove;
+    uint64_t suggestedHash = 0;
+
+    // Set by start_search until poll, wait or stop has collected the search's move.
+    bool searchPending = false;
+    bool searchPlays = true;
+    Occupant searchSide = Occupant::BLACK;
 
 public:
-    AbaloneAIPybind(int depth = 4, int timeLimitMs = 5000, size_t ttSizeInMB = 64) 
-        : ai(depth, timeLimitMs, ttSizeInMB) {}
+    AbaloneAIPybind(int depth = 4, int timeLimitMs = 5000, size_t ttSizeInMB = 64, int threads = 0,
+                    bool lateMoveReductions = true, bool nullMovePruning = true, bool ponder = false)
+        : ai(depth, timeLimitMs, ttSizeInMB, makeOptions(threads, lateMoveReductions, nullMovePruning)),
+          ponderEnabled(ponder) {}
+
+    ~AbaloneAIPybind() {
+        // The search thread may be waiting for the GIL to report progress.
+        pybind11::gil_scoped_release release;
+        ai.stopSearching();
+        ai.stopPondering();
+    }
 
-    void parse_board_state(const std::string& board_state) {
+    // Loads the session board from the GUI's board string; 'black_moves' and
+    // 'white_moves' are the moves each side has made so far in the game.
+    void parse_board_state(const std::string& board_state, int black_moves, int white_moves) {
+        require_no_search();
         board = Board();
+        history.clear();
+        movesMade = { black_moves, white_moves };
 
         std::istringstream ss(board_state);
         std::string line;
@@ -38,44 +223,388 @@ public:
             int index = Board::notationToIndex(notation);
             if (index < 0 || index >= Board::NUM_CELLS) continue;
 
-            board.occupant[index] = color;
-            auto [x, y] = Board::s_indexToCoord[index];
-            if (color == Occupant::BLACK)
-                board.blackOccupantsCoords.emplace_back(x, y);
-            else
-                board.whiteOccupantsCoords.emplace_back(x, y);
+            board.setOccupant(index, color);
         }
     }
 
+    // Searches for the side to move and plays the move on our board. Blocks until
+    // the search is done, but without holding the GIL, so other Python threads run.
     std::tuple<std::string, std::string> find_best_move(int move_count, int total_moves) {
-        // Use a fixed max search depth (e.g., 10) or allow it to be configurable
-        int maxSearchDepth = 10;
-        auto result = ai.findBestMoveIterativeDeepening(board, maxSearchDepth, move_count, total_moves);
+        require_no_search();
+        ai.setProgressCallback(nullptr);
         Occupant side = board.nextToMove;
-        std::string moveStr = board.moveToNotation(result.first, side);
-        board.applyMove(result.first);
-        std::string updatedBoard = board.toBoardString();
-        return std::make_tuple(moveStr, updatedBoard);
+        std::pair<Move, int> result;
+        {
+            pybind11::gil_scoped_release release;
+            result = ai.findBestMoveIterativeDeepening(board, MAX_SEARCH_DEPTH, move_count, total_moves);
+        }
+        return play_result(result.first, side);
+    }
+
+    // Starts the search for the side to move on the engine's own thread and
+    // returns at once; collect the move with poll(), wait() or stop(). If given,
+    // 'progress' is called after every completed depth with a dict (depth, score,
+    // nodes, elapsed_ms, move). It runs on the search thread, so a GUI should only
+    // hand the values over to its own thread there. With play=False the move is
+    // only reported, as by best_move, and left for apply_move.
+    void start_search(int move_count, int total_moves, pybind11::object progress, bool play) {
+        require_no_search();
+        searchSide = board.nextToMove;
+        searchPlays = play;
+        if (progress.is_none()) {
+            ai.setProgressCallback(nullptr);
+        }
+        else {
+            Occupant side = searchSide;
+            ai.setProgressCallback([progress, side](const SearchProgress& p) {
+                pybind11::gil_scoped_acquire gil;
+                try {
+                    pybind11::dict info;
+                    info["depth"] = p.depth;
+                    info["score"] = p.score;
+                    info["nodes"] = p.nodes;
+                    info["elapsed_ms"] = p.elapsedMs;
+                    info["move"] = Board::moveToNotation(p.bestMove, side);
+                    progress(info);
+                }
+                catch (pybind11::error_already_set& e) {
+                    // Nobody on the search thread could handle it.
+                    e.discard_as_unraisable("abalone_ai progress callback");
+                }
+            });
+        }
+        ai.startSearch(board, MAX_SEARCH_DEPTH, move_count, total_moves);
+        searchPending = true;
+    }
+
+    // None while the search started by start_search is running, then the same
+    // (move, updated board) as find_best_move. poll, wait and stop return None
+    // when there is no search to collect.
+    pybind11::object poll() {
+        if (!searchPending || ai.isSearching()) {
+            return pybind11::none();
+        }
+        return finish_search(ai.waitForSearch());
+    }
+
+    // Blocks (without the GIL) until the search started by start_search is done.
+    pybind11::object wait() {
+        if (!searchPending) {
+            return pybind11::none();
+        }
+        std::pair<Move, int> result;
+        {
+            pybind11::gil_scoped_release release;
+            result = ai.waitForSearch();
+        }
+        return finish_search(result);
+    }
+
+    // Ends the search started by start_search and plays the best move found so far.
+    pybind11::object stop() {
+        if (!searchPending) {
+            return pybind11::none();
+        }
+        std::pair<Move, int> result;
+        {
+            pybind11::gil_scoped_release release;
+            result = ai.stopSearching();
+        }
+        return finish_search(result);
+    }
+
+    // Tells the engine the opponent's reply to our last move, in the notation
+    // find_best_move returns (e.g. "(w, C5, D5) i → NW"). Returns true on a ponder
+    // hit: the next find_best_move continues the search already under way.
+    // Otherwise the pondering is discarded (what it stored in the table is kept).
+    bool opponent_moved(const std::string& move) {
+        apply_move(move);
+        return ai.isPonderingOn(board);
+    }
+
+    // ---- Game session: the board lives here for the whole game, and only
+    // ---- single moves cross the language boundary.
+
+    // Starts a game from "standard", "belgian daisy" or "german daisy" (case
+    // insensitive), Black to move. The engine forgets the previous game.
+    // 'moves_per_team' is the game's move limit, as given to find_best_move.
+    void new_game(const std::string& layout, int moves_per_team) {
+        require_no_search();
+        std::string name = layout;
+        std::transform(name.begin(), name.end(), name.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        Board fresh;
+        if (name == "standard") {
+            fresh.initStandardLayout();
+        }
+        else if (name == "belgian daisy") {
+            fresh.initBelgianDaisyLayout();
+        }
+        else if (name == "german daisy") {
+            fresh.initGermanDaisyLayout();
+        }
+        else {
+            throw std::invalid_argument("Unknown layout: " + layout);
+        }
+        fresh.nextToMove = Occupant::BLACK;
+
+        ai.newGame();
+        board = fresh;
+        history.clear();
+        movesMade = { 0, 0 };
+        movesPerTeam = moves_per_team;
+        suggestedMove = Move();
+    }
+
+    // Plays a move of the side to move, in document notation (marbles in any
+    // order), and returns it as the engine writes it. Pondering continues if it
+    // was on the resulting position and starts if this is the move best_move
+    // suggested.
+    std::string apply_move(const std::string& move) {
+        require_no_search();
+        Move parsed = board.moveFromNotation(move);
+        if (parsed.isNull()) {
+            throw std::invalid_argument("Not a legal move: " + move);
+        }
+        std::string notation = Board::moveToNotation(parsed, board.nextToMove);
+        bool suggested = parsed == suggestedMove && board.hash() == suggestedHash;
+        movesMadeBy(board.nextToMove)++;
+        history.emplace_back(parsed, board.makeMove(parsed));
+
+        if (!ai.isPonderingOn(board)) {
+            ai.stopPondering();
+            if (ponderEnabled && suggested) {
+                ai.startPondering(board, MAX_SEARCH_DEPTH);
+            }
+        }
+        return notation;
+    }
+
+    // Takes back the last move played on the session board and returns it.
+    std::string undo() {
+        require_no_search();
+        if (history.empty()) {
+            throw std::out_of_range("No move to undo");
+        }
+        ai.stopPondering();
+        board.unmakeMove(history.back().second);
+        movesMadeBy(board.nextToMove)--;
+        Move move = history.back().first;
+        history.pop_back();
+        return Board::moveToNotation(move, board.nextToMove);
+    }
+
+    // Searches the session board and returns the move for the side to move,
+    // without playing it (that is apply_move's job). The GIL is released meanwhile.
+    std::string best_move() {
+        require_no_search();
+        ai.setProgressCallback(nullptr);
+        int moveCount = movesMadeBy(board.nextToMove);
+        std::pair<Move, int> result;
+        {
+            pybind11::gil_scoped_release release;
+            result = ai.findBestMoveIterativeDeepening(board, MAX_SEARCH_DEPTH, moveCount, movesPerTeam);
+        }
+        return suggest(result.first);
+    }
+
+    int ply_count() const {
+        return static_cast<int>(history.size());
+    }
+
+    // ---- NumPy batch analysis (see PositionBatch for the board formats).
+
+    // Static evaluation of each position with 'to_move' to move, from Black's
+    // point of view as in the search, as int32[N].
+    pybind11::array_t<int32_t> evaluate_batch(const pybind11::array& positions, const std::string& to_move) {
+        Occupant side = sideFromString(to_move);
+        PositionBatch batch = readPositions(positions);
+        pybind11::array_t<int32_t> scores(batch.count);
+        int32_t* out = scores.mutable_data();
+        pybind11::gil_scoped_release release;
+        ai.evaluateBatch(batch.data, batch.count, side, out);
+        return scores;
+    }
+
+    // Searches every position with 'to_move' to move, one after the other, to
+    // 'depth' plies (capped at 'time_limit_ms' per position if positive), with no
+    // root rules and no logging: (move codes uint32[N], scores int32[N]). The
+    // session board is not touched.
+    pybind11::tuple best_move_batch(const pybind11::array& positions, const std::string& to_move, int depth,
+                                    int time_limit_ms) {
+        require_no_search();
+        Occupant side = sideFromString(to_move);
+        PositionBatch batch = readPositions(positions);
+        pybind11::array_t<uint32_t> moves(batch.count);
+        pybind11::array_t<int32_t> scores(batch.count);
+        uint32_t* moveOut = moves.mutable_data();
+        int32_t* scoreOut = scores.mutable_data();
+        {
+            pybind11::gil_scoped_release release;
+            for (int p = 0; p < batch.count; p++) {
+                std::pair<Move, int> result = ai.analysePosition(Board(batch.data[p], side), depth, time_limit_ms);
+                moveOut[p] = result.first.code;
+                scoreOut[p] = result.second;
+            }
+        }
+        return pybind11::make_tuple(moves, scores);
+    }
+
+    // The session board as int8[61] occupancy or, with bitboards=True, uint64[2].
+    pybind11::array board_array(bool bitboards) const {
+        if (bitboards) {
+            pybind11::array_t<uint64_t> result(2);
+            std::memcpy(result.mutable_data(), board.bitboards.data(), 2 * sizeof(uint64_t));
+            return result;
+        }
+        pybind11::array_t<int8_t> result(Board::NUM_CELLS);
+        int8_t* cells = result.mutable_data();
+        for (int cell = 0; cell < Board::NUM_CELLS; cell++) {
+            cells[cell] = static_cast<int8_t>(board.getOccupant(cell));
+        }
+        return result;
+    }
+
+    // Replaces the session board with one position in either NumPy format, like
+    // parse_board_state without the string.
+    void set_board_array(const pybind11::array& position, const std::string& to_move, int black_moves,
+                         int white_moves) {
+        require_no_search();
+        Occupant side = sideFromString(to_move);
+        PositionBatch batch = readPositions(position);
+        if (batch.count != 1) {
+            throw std::invalid_argument("set_board_array takes a single position");
+        }
+        board = Board(batch.data[0], side);
+        history.clear();
+        movesMade = { black_moves, white_moves };
+    }
+
+    void stop_pondering() {
+        ai.stopPondering();
     }
 
     std::string get_current_board_string() const {
         return board.toBoardString();
     }
 
+    void set_time_control(int move_time_ms, int remaining_ms, int increment_ms, int moves_to_go) {
+        TimeControl control;
+        control.moveTimeMs = move_time_ms;
+        control.remainingMs = remaining_ms;
+        control.incrementMs = increment_ms;
+        control.movesToGo = moves_to_go;
+        ai.setTimeControl(control);
+    }
+
+    pybind11::dict eval_cache_stats() const {
+        EvalCache::Stats stats = ai.getEvalCacheStats();
+        pybind11::dict result;
+        result["probes"] = stats.probes;
+        result["hits"] = stats.hits;
+        result["hit_rate"] = stats.hitRate();
+        return result;
+    }
+
 private:
-    std::string format_move(const Move& move, Occupant side) {
-        return board.moveToNotation(move, side);
+    int& movesMadeBy(Occupant side) {
+        return movesMade[side == Occupant::BLACK ? 0 : 1];
+    }
+
+    void require_no_search() const {
+        if (searchPending) {
+            throw std::runtime_error("A search is in progress; collect it with wait() or stop() first");
+        }
+    }
+
+    // Plays 'move' for 'side' on our board and, if enabled, starts pondering the reply.
+    std::tuple<std::string, std::string> play_result(const Move& move, Occupant side) {
+        std::string moveStr = board.moveToNotation(move, side);
+        if (!move.isNull()) {
+            movesMadeBy(side)++;
+            history.emplace_back(move, board.makeMove(move));
+        }
+        std::string updatedBoard = board.toBoardString();
+
+        // Keep thinking on the opponent's time.
+        if (ponderEnabled && !move.isNull()) {
+            ai.startPondering(board, MAX_SEARCH_DEPTH);
+        }
+        return std::make_tuple(moveStr, updatedBoard);
+    }
+
+    // Remembers 'move' as best_move's suggestion for the current position.
+    std::string suggest(const Move& move) {
+        suggestedMove = move;
+        suggestedHash = board.hash();
+        return Board::moveToNotation(move, board.nextToMove);
+    }
+
+    // Plays (or, for start_search(play=False), only reports) the move of the
+    // finished background search.
+    pybind11::object finish_search(const std::pair<Move, int>& result) {
+        searchPending = false;
+        if (!searchPlays) {
+            return pybind11::cast(std::make_tuple(suggest(result.first), board.toBoardString()));
+        }
+        return pybind11::cast(play_result(result.first, searchSide));
+    }
+
+    static SearchOptions makeOptions(int threads, bool lateMoveReductions, bool nullMovePruning) {
+        SearchOptions options;
+        options.threads = threads;
+        options.lateMoveReductions = lateMoveReductions;
+        options.nullMovePruning = nullMovePruning;
+        return options;
     }
 };
 
 PYBIND11_MODULE(abalone_ai, m) {
     pybind11::class_<AbaloneAIPybind>(m, "AbaloneAI")
-        .def(pybind11::init<int, int, size_t>(),
+        .def(pybind11::init<int, int, size_t, int, bool, bool, bool>(),
              pybind11::arg("depth") = 4,
              pybind11::arg("time_limit_ms") = 5000,
-             pybind11::arg("tt_size_mb") = 64)
-        .def("parse_board_state", &AbaloneAIPybind::parse_board_state)
+             pybind11::arg("tt_size_mb") = 64,
+             pybind11::arg("threads") = 0,
+             pybind11::arg("late_move_reductions") = true,
+             pybind11::arg("null_move_pruning") = true,
+             pybind11::arg("ponder") = false)
+        .def("parse_board_state", &AbaloneAIPybind::parse_board_state,
+             pybind11::arg("board_state"), pybind11::arg("black_moves") = 0, pybind11::arg("white_moves") = 0)
         .def("find_best_move", &AbaloneAIPybind::find_best_move,
              pybind11::arg("move_count"), pybind11::arg("total_moves"))
-        .def("get_current_board_string", &AbaloneAIPybind::get_current_board_string);
+        .def("start_search", &AbaloneAIPybind::start_search,
+             pybind11::arg("move_count"), pybind11::arg("total_moves"), pybind11::arg("progress") = pybind11::none(),
+             pybind11::arg("play") = true)
+        .def("poll", &AbaloneAIPybind::poll)
+        .def("wait", &AbaloneAIPybind::wait)
+        .def("stop", &AbaloneAIPybind::stop)
+        .def("opponent_moved", &AbaloneAIPybind::opponent_moved, pybind11::arg("move"))
+        .def("new_game", &AbaloneAIPybind::new_game,
+             pybind11::arg("layout") = "standard", pybind11::arg("moves_per_team") = 100)
+        .def("apply_move", &AbaloneAIPybind::apply_move, pybind11::arg("move"))
+        .def("undo", &AbaloneAIPybind::undo)
+        .def("best_move", &AbaloneAIPybind::best_move)
+        .def("ply_count", &AbaloneAIPybind::ply_count)
+        .def("evaluate_batch", &AbaloneAIPybind::evaluate_batch,
+             pybind11::arg("positions"), pybind11::arg("to_move") = "b")
+        .def("best_move_batch", &AbaloneAIPybind::best_move_batch,
+             pybind11::arg("positions"), pybind11::arg("to_move") = "b",
+             pybind11::arg("depth") = 4, pybind11::arg("time_limit_ms") = 0)
+        .def("board_array", &AbaloneAIPybind::board_array, pybind11::arg("bitboards") = false)
+        .def("set_board_array", &AbaloneAIPybind::set_board_array,
+             pybind11::arg("position"), pybind11::arg("to_move") = "b", pybind11::arg("black_moves") = 0,
+             pybind11::arg("white_moves") = 0)
+        .def("stop_pondering", &AbaloneAIPybind::stop_pondering)
+        .def("get_current_board_string", &AbaloneAIPybind::get_current_board_string)
+        .def("set_time_control", &AbaloneAIPybind::set_time_control,
+             pybind11::arg("move_time_ms"), pybind11::arg("remaining_ms") = 0,
+             pybind11::arg("increment_ms") = 0, pybind11::arg("moves_to_go") = 0)
+        .def("eval_cache_stats", &AbaloneAIPybind::eval_cache_stats);
+
+    m.def("legal_move_count_batch", &legal_move_count_batch,
+          pybind11::arg("positions"), pybind11::arg("to_move") = "b");
+    m.def("generate_moves_batch", &generate_moves_batch,
+          pybind11::arg("positions"), pybind11::arg("to_move") = "b");
+    m.def("move_notation", &move_notation, pybind11::arg("code"), pybind11::arg("to_move"));
 }
\ No newline at end of file
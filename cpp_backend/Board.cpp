@@ -27,27 +27,7 @@ namespace std {
 
 using namespace std;
 
-// Helper: Convert occupant enum to a string.
-static string occupantToString(Occupant occ) {
-    switch (occ) {
-    case Occupant::EMPTY: return "EMPTY";
-    case Occupant::BLACK: return "BLACK";
-    case Occupant::WHITE: return "WHITE";
-    default: return "UNKNOWN";
-    }
-}
-
-// Directions in (dm, dy) form, matching your doc
-const array<pair<int, int>, Board::NUM_DIRECTIONS> Board::DIRECTION_OFFSETS = { {
-    {-1,  0}, // W
-    {+1,  0}, // E
-    { 0, +1}, // NW
-    {+1, +1}, // NE
-    {-1, -1}, // SW
-    { 0, -1}  // SE
-} };
 
-static const array<int, Board::NUM_DIRECTIONS> OPPOSITES = { 1, 0, 5, 4, 3, 2 };
 
 
 bool Board::isGroupAligned(const std::vector<int>& group, int& alignedDirection) const {
@@ -82,145 +62,149 @@ bool Board::isGroupAligned(const std::vector<int>& group, int& alignedDirection)
 }
 
 
-bool Board::tryMove(const vector<int>& group, int direction, Move& move) const {
-    DEBUG_PRINT("Trying move for group: ");
-    for (int idx : group)
-        DEBUG_PRINT(indexToNotation(idx) << " ");
-    DEBUG_PRINT("in direction " << direction << "\n");
-
-    Board temp = *this;
-    move.marbleIndices = group;
-    move.direction = direction;
-    if (group.size() == 1) {
-        move.isInline = false;
+bool Board::buildMove(int anchor, int length, int axis, int direction, Occupant side, Move& move) const {
+    array<int, Move::MAX_GROUP_SIZE> group;
+    group[0] = anchor;
+    for (int i = 1; i < length; i++) {
+        group[i] = neighbors[group[i - 1]][axis];
     }
-    else {
-        int alignedDir;
-        if (isGroupAligned(group, alignedDir)) {
-            DEBUG_PRINT("Group is aligned. Aligned direction: " << alignedDir << "\n");
-            move.isInline = (direction == alignedDir || direction == OPPOSITES[alignedDir]);
-        }
-        else {
-            move.isInline = false;
+
+    bool isInline = length > 1 && (direction == axis || direction == oppositeDirection(axis));
+    if (!isInline) {
+        // Side-step (or single marble): every destination must be an empty cell.
+        for (int i = 0; i < length; i++) {
+            int target = neighbors[group[i]][direction];
+            if (target < 0 || occupant[target] != Occupant::EMPTY) {
+                return false;
+            }
         }
+        move = Move(anchor, length, axis, direction, false, 0);
+        return true;
     }
-    try {
-        temp.applyMove(move);
-    }
-    catch (const runtime_error& e) {
-        DEBUG_PRINT("Move failed: " << e.what() << "\n");
+
+    // Inline: only the cell in front of the leading marble matters.
+    int front = (direction == axis) ? group[length - 1] : group[0];
+    int dest = neighbors[front][direction];
+    if (dest < 0 || occupant[dest] == side) {
         return false;
     }
-    DEBUG_PRINT("Move succeeded for group: ");
-    for (int idx : group)
-        DEBUG_PRINT(indexToNotation(idx) << " ");
-    DEBUG_PRINT("direction " << direction << "\n");
-    return true;
-}
-
-
-#include <thread>
-#include <mutex>
-#include <set>
-#include <vector>
-#include <iostream>
-
-#include <thread>
-#include <mutex>
-#include <set>
-#include <vector>
-#include <iostream>
 
-std::mutex groupMutex;  // Mutex to ensure thread safety when modifying shared data
+    int pushCount = 0;
+    int cell = dest;
+    while (cell >= 0 && occupant[cell] != Occupant::EMPTY && occupant[cell] != side) {
+        pushCount++;
+        if (pushCount >= length) {
+            return false;  // Cannot push: opponent group too large.
+        }
+        cell = neighbors[cell][direction];
+    }
+    if (cell >= 0 && occupant[cell] == side) {
+        return false;  // Push blocked by one of our own marbles.
+    }
 
-static long long packCoord(int m, int y) {
-    return (static_cast<long long>(m) << 32) ^ (static_cast<long long>(y) & 0xffffffff);
+    move = Move(anchor, length, axis, direction, true, pushCount);
+    return true;
 }
 
-
-
-
-
-// ========================== Group Detection Functions ========================== //
-
-// ========================== Group Detection Functions ========================== //
-
-
-
-std::set<std::vector<int>> Board::generateGroups(Occupant side) const {
-    std::set<std::vector<int>> groups;
-    const std::vector<std::pair<int, int>>* targetList = nullptr;
-
-    // Select the target list based on occupant color
-    if (side == Occupant::BLACK) {
-        targetList = &blackOccupantsCoords;
-    } else if (side == Occupant::WHITE) {
-        targetList = &whiteOccupantsCoords;
+bool Board::isLegalMove(const Move& move) const {
+    int anchor = move.anchor();
+    int length = move.length();
+    if (anchor >= NUM_CELLS || length < 1 || length > Move::MAX_GROUP_SIZE ||
+        move.axis() > 3 || move.direction() >= NUM_DIRECTIONS) {
+        return false;
     }
 
-    for (const auto& coordinate : *targetList) {
-        long long key = packCoord(coordinate.first, coordinate.second);
-        auto it = s_coordToIndex.find(key);
-        if (it == s_coordToIndex.end()) continue;  // Skip if coordinate is invalid
-
-        int idx = it->second;
-        groups.insert({idx});  // Add single-marble group
-
-        for (int i = 1; i <= 3; i++) {  // Only iterate over necessary directions
-            int first_neighbour_index = neighbors[idx][i];
-
-            // Ensure first neighbor is valid and belongs to the same player
-            if (first_neighbour_index == -1 || occupant[first_neighbour_index] != side) continue;
-
-            std::vector<int> twoMarbleGroup = {idx, first_neighbour_index};
-            std::sort(twoMarbleGroup.begin(), twoMarbleGroup.end());
-            groups.insert(twoMarbleGroup);  // Insert two-marble group
-
-            int second_neighbour_index = neighbors[first_neighbour_index][i];
-
-            if (second_neighbour_index == -1 || occupant[second_neighbour_index] != side) continue;
+    Occupant side = occupant[anchor];
+    if (side == Occupant::EMPTY) {
+        return false;
+    }
 
-            std::vector<int> threeMarbleGroup = {idx, first_neighbour_index, second_neighbour_index};
-            std::sort(threeMarbleGroup.begin(), threeMarbleGroup.end());
-            groups.insert(threeMarbleGroup);  // Insert three-marble group
+    // The group must be a line of same-colored marbles on the board.
+    int cell = anchor;
+    for (int i = 1; i < length; i++) {
+        cell = neighbors[cell][move.axis()];
+        if (cell < 0 || occupant[cell] != side) {
+            return false;
         }
     }
 
+    Move expected;
+    return buildMove(anchor, length, move.axis(), move.direction(), side, expected) && expected == move;
+}
 
+bool Board::isCaptureMove(const Move& move) const {
+    if (!move.isInline() || move.pushCount() == 0) {
+        return false;
+    }
 
-    return groups;
+    // Walk from the leading marble past the pushed chain; a capture runs off the board.
+    array<int, Move::MAX_GROUP_SIZE> group;
+    int groupSize = move.getMarbles(group);
+    int d = move.direction();
+    int front = (d == move.axis()) ? group[groupSize - 1] : group[0];
+    int cell = neighbors[front][d];
+    for (int i = 0; i < move.pushCount() && cell >= 0; i++) {
+        cell = neighbors[cell][d];
+    }
+    return cell < 0;
 }
 
 
+// ========================== Group Detection Functions ========================== //
 
+int Board::generateGroups(Occupant side, GroupBuffer& groups) const {
+    uint64_t own = getBitboard(side);
+    int count = 0;
 
+    // Only segments anchored on one of our marbles can be fully ours.
+    uint64_t anchors = own;
+    while (anchors) {
+        int anchor = lowestSetBit(anchors);
+        anchors &= anchors - 1;
 
+        for (int s = BoardGeometry::SEGMENT_BEGIN[anchor]; s < BoardGeometry::SEGMENT_BEGIN[anchor + 1]; s++) {
+            const BoardGeometry::Segment& segment = BoardGeometry::SEGMENTS[s];
+            if ((segment.mask & ~own) == 0) {
+                groups[count++] = &segment;
+            }
+        }
+    }
+    return count;
+}
 
 
 /**
  * @brief Generates all legal moves for a given side.
  *
- * This function replaces `dfsGroup` with `generateParallelGroups`
- * for improved performance using multi-threading.
+ * Groups come from the static segment table (see generateGroups), so no
+ * containers are allocated; moves are listed in group order, then direction.
  *
  * @param side The player (Black or White) for whom to generate moves.
  * @return A list of valid moves.
  */
-std::vector<Move> Board::generateMoves(Occupant side) const {
-    std::vector<Move> moves;  // Stores all valid moves
-
-    // Generate unique groups using the multi-threaded approach
-    std::set<std::vector<int>> candidateGroups = generateGroups(side);
+MoveList Board::generateMoves(Occupant side) const {
+    MoveList moves;  // Stores all valid moves
 
+    GroupBuffer groups;
+    int groupCount = generateGroups(side, groups);
+    uint64_t occupied = bitboards[0] | bitboards[1];
 
     // Iterate over each group and attempt moves in all directions
-    for (const auto& group : candidateGroups) {
+    for (int g = 0; g < groupCount; g++) {
+        const BoardGeometry::Segment& group = *groups[g];
         for (int d = 0; d < NUM_DIRECTIONS; d++) {
-
+            bool isInline = group.length > 1 && (d == group.axis || d == oppositeDirection(group.axis));
+            if (!isInline) {
+                // Side-step: legal exactly when every target cell is on the board and empty.
+                uint64_t targets = group.targets[d];
+                if (targets != 0 && (targets & occupied) == 0) {
+                    moves.push_back(Move(group.anchor, group.length, group.axis, d, false, 0));
+                }
+                continue;
+            }
 
             Move candidateMove;
-
-            if (tryMove(group, d, candidateMove)) { // Validate and apply move logic
+            if (buildMove(group.anchor, group.length, group.axis, d, side, candidateMove)) {
                 moves.push_back(candidateMove);
             }
         }
@@ -231,135 +215,118 @@ std::vector<Move> Board::generateMoves(Occupant side) const {
 
 
 
-void Board::applyMove(const Move& m) {
-    if (m.marbleIndices.empty()) {
-        throw runtime_error("No marbles in move.");
-    }
-    int d = m.direction;
-    static const char* DIRS[] = { "W", "E", "NW", "NE", "SW", "SE" };
-    DEBUG_PRINT("Applying move: "
-        << (occupant[m.marbleIndices[0]] == Occupant::BLACK ? "b" : "w")
-        << ", group (size " << m.marbleIndices.size() << "): ");
-    for (int idx : m.marbleIndices)
-        DEBUG_PRINT(indexToNotation(idx) << " ");
-    DEBUG_PRINT(", direction: " << d << " (" << DIRS[d] << ")"
-        << (m.isInline ? " [inline]" : " [side-step]") << "\n");
-    if (m.isInline) {
-        int front = getFrontCell(m.marbleIndices, m.direction);
+int Board::collectChanges(const Move& m, array<CellChange, UndoInfo::MAX_CHANGES>& changes) const {
+    array<int, Move::MAX_GROUP_SIZE> group;
+    int groupSize = m.getMarbles(group);
+    int d = m.direction();
+    Occupant side = occupant[group[0]];
+    int count = 0;
+
+    if (m.isInline()) {
+        // Only the ends of the line change: the tail empties, the cell in front
+        // becomes ours, and a pushed chain grows by one cell at its far end
+        // (or loses its last marble off the board).
+        bool forward = (d == m.axis());
+        int front = forward ? group[groupSize - 1] : group[0];
+        int tail = forward ? group[0] : group[groupSize - 1];
         int dest = neighbors[front][d];
-        DEBUG_PRINT("  Front cell: " << indexToNotation(front)
-            << ", destination: " << (dest >= 0 ? indexToNotation(dest) : "off-board"));
-        if (dest >= 0) {
-            DEBUG_PRINT(" (occupant: " << occupantToString(occupant[dest]) << ")");
-        }
-        DEBUG_PRINT("\n");
-
-        if (dest >= 0 && occupant[dest] != Occupant::EMPTY && occupant[dest] != occupant[front]) {
-            int oppCount = 0;
-            int cell = dest;
-            while (cell >= 0 && occupant[cell] != Occupant::EMPTY &&
-                occupant[cell] != occupant[front]) {
-                oppCount++;
-                cell = neighbors[cell][d];
-            }
-            DEBUG_PRINT("  Push detection: oppCount = " << oppCount);
-            DEBUG_PRINT(", final cell after push loop = " << (cell >= 0 ? indexToNotation(cell) : "off-board"));
-            if (cell >= 0)
-                DEBUG_PRINT(" (occupant: " << occupantToString(occupant[cell]) << ")");
-            DEBUG_PRINT("\n");
-            if (oppCount >= m.marbleIndices.size()) {
-                throw runtime_error("Illegal move: cannot push, opponent group too large.");
-            }
-            if (cell >= 0 && occupant[cell] != Occupant::EMPTY) {
-                throw runtime_error("Illegal move: push blocked, destination not empty.");
-            }
-            DEBUG_PRINT("  Push detected: pushing " << oppCount
-                << " opponent marble" << (oppCount > 1 ? "s" : "") << ".\n");
-            vector<int> chain;
-            cell = dest;
-            for (int i = 0; i < oppCount; i++) {
-                chain.push_back(cell);
-                cell = neighbors[cell][d];
-            }
-            for (int i = chain.size() - 1; i >= 0; i--) {
-                int from = chain[i];
-                int to = (i == chain.size() - 1) ? cell : chain[i + 1];
-                if (to < 0) {
-                    //TODO:Hello
-                    occupant[from] = Occupant::EMPTY;
-                    updateOccupantCoordinates(from, -1, occupant[from]); // -1 means remove only
-                    DEBUG_PRINT("    Marble at " << indexToNotation(from)
-                        << " pushed off-board.\n");
-                }
-                else {
-                    if (occupant[to] != Occupant::EMPTY)
-                        throw runtime_error("Illegal move: push blocked while moving opponent marbles.");
-                    //TODO:Hello
-                    occupant[to] = occupant[from];
-                    updateOccupantCoordinates(from, to, occupant[to]);
-                    occupant[from] = Occupant::EMPTY;
-                    DEBUG_PRINT("    Marble at " << indexToNotation(from)
-                        << " moved to " << indexToNotation(to) << ".\n");
-                }
-            }
-        }
 
-        // Now, we need to move our own marbles.
-        // Sort the moving group by dot-product with the move offset so that the marble furthest in the direction is last.
-        auto offset = DIRECTION_OFFSETS[d];
-        vector<int> sortedGroup = m.marbleIndices;
-        sort(sortedGroup.begin(), sortedGroup.end(), [&](int a, int b) {
-            auto ca = s_indexToCoord[a];
-            auto cb = s_indexToCoord[b];
-            int scoreA = offset.first * ca.first + offset.second * ca.second;
-            int scoreB = offset.first * cb.first + offset.second * cb.second;
-            return scoreA < scoreB; // lower scores come first
-            });
-
-        // Move our own marbles in reverse order.
-        for (auto it = sortedGroup.rbegin(); it != sortedGroup.rend(); ++it) {
-            int idx = *it;
-            int target = neighbors[idx][d];
-            DEBUG_PRINT("  Moving " << indexToNotation(idx) << " to "
-                << (target >= 0 ? indexToNotation(target) : "off-board") << "\n");
-            if (target < 0) {
-                throw runtime_error("Illegal move: marble would move off-board.");
+        changes[count++] = { static_cast<int8_t>(tail), side, Occupant::EMPTY };
+        changes[count++] = { static_cast<int8_t>(dest), occupant[dest], side };
+        if (m.pushCount() > 0) {
+            int chainEnd = dest;
+            for (int i = 0; i < m.pushCount() && chainEnd >= 0; i++) {
+                chainEnd = neighbors[chainEnd][d];
             }
-            if (occupant[target] != Occupant::EMPTY) {
-                throw runtime_error("Illegal move: destination cell is not empty for inline move.");
+            if (chainEnd >= 0) {
+                changes[count++] = { static_cast<int8_t>(chainEnd), Occupant::EMPTY, occupant[dest] };
             }
-            //TODO: HELLO
-
-
-            occupant[target] = occupant[idx];
-            updateOccupantCoordinates(idx, target, occupant[target]);
-            occupant[idx] = Occupant::EMPTY;
         }
     }
     else {
-        for (int idx : m.marbleIndices) {
-            int target = neighbors[idx][d];
-            DEBUG_PRINT("  Side-stepping " << indexToNotation(idx) << " to "
-                << (target >= 0 ? indexToNotation(target) : "off-board") << "\n");
-            if (target < 0) {
-                throw runtime_error("Illegal move: side-step moves off-board.");
-            }
-            if (occupant[target] != Occupant::EMPTY) {
-                throw runtime_error("Illegal move: destination cell is not empty for side-step.");
-            }
-            //TODO: HELLO
-            occupant[target] = occupant[idx];
-            updateOccupantCoordinates(idx, target, occupant[target]);
-            occupant[idx] = Occupant::EMPTY;
+        for (int i = 0; i < groupSize; i++) {
+            changes[count++] = { static_cast<int8_t>(group[i]), side, Occupant::EMPTY };
+        }
+        for (int i = 0; i < groupSize; i++) {
+            changes[count++] = { static_cast<int8_t>(neighbors[group[i]][d]), Occupant::EMPTY, side };
         }
     }
+    return count;
 }
 
-int Board::getFrontCell(const vector<int>& group, int direction) const {
-    auto offset = DIRECTION_OFFSETS[direction];
-    int bestIdx = group.front();
+void Board::applyMove(const Move& m) {
+    if (m.isNull()) {
+        return;
+    }
+    static const char* DIRS[] = { "W", "E", "NW", "NE", "SW", "SE" };
+    DEBUG_PRINT("Applying move: " << moveToNotation(m, occupant[m.anchor()])
+        << " (direction " << DIRS[m.direction()] << ")\n");
+
+    array<CellChange, UndoInfo::MAX_CHANGES> changes;
+    int count = collectChanges(m, changes);
+    for (int i = 0; i < count; i++) {
+        setCell(changes[i].cell, changes[i].after);
+    }
+}
+
+UndoInfo Board::makeMove(const Move& m) {
+    UndoInfo undo;
+    undo.count = collectChanges(m, undo.changes);
+    for (int i = 0; i < undo.count; i++) {
+        setCell(undo.changes[i].cell, undo.changes[i].after);
+    }
+    nextToMove = (nextToMove == Occupant::BLACK) ? Occupant::WHITE : Occupant::BLACK;
+    return undo;
+}
+
+void Board::unmakeMove(const UndoInfo& undo) {
+    for (int i = undo.count - 1; i >= 0; i--) {
+        setCell(undo.changes[i].cell, undo.changes[i].before);
+    }
+    nextToMove = (nextToMove == Occupant::BLACK) ? Occupant::WHITE : Occupant::BLACK;
+}
+
+array<uint64_t, 2> Board::bitboardsAfter(const Move& m) const {
+    array<CellChange, UndoInfo::MAX_CHANGES> changes;
+    int count = collectChanges(m, changes);
+    array<uint64_t, 2> result = bitboards;
+    for (int i = 0; i < count; i++) {
+        uint64_t bit = 1ULL << changes[i].cell;
+        result[0] &= ~bit;
+        result[1] &= ~bit;
+        if (changes[i].after == Occupant::BLACK) result[0] |= bit;
+        else if (changes[i].after == Occupant::WHITE) result[1] |= bit;
+    }
+    return result;
+}
+
+void Board::applyMoveChecked(const Move& m) {
+    if (m.isNull()) {
+        throw runtime_error("No marbles in move.");
+    }
+    if (!isLegalMove(m)) {
+        throw runtime_error("Illegal move: move code " + to_string(m.code) + " is not legal in this position.");
+    }
+    applyMove(m);
+}
+
+int Move::getMarbles(array<int, MAX_GROUP_SIZE>& cells) const {
+    int count = length();
+    cells[0] = anchor();
+    for (int i = 1; i < count; i++) {
+        cells[i] = Board::neighbors[cells[i - 1]][axis()];
+    }
+    return count;
+}
+
+int Board::getFrontCell(const Move& move) const {
+    array<int, Move::MAX_GROUP_SIZE> group;
+    int groupSize = move.getMarbles(group);
+    auto offset = DIRECTION_OFFSETS[move.direction()];
+    int bestIdx = group[0];
     int bestScore = numeric_limits<int>::min();
-    for (int idx : group) {
+    for (int i = 0; i < groupSize; i++) {
+        int idx = group[i];
         auto coord = s_indexToCoord[idx];  // (m, y)
         int score = offset.first * coord.first + offset.second * coord.second;
         if (score > bestScore) {
@@ -373,9 +340,11 @@ int Board::getFrontCell(const vector<int>& group, int direction) const {
 string Board::moveToNotation(const Move& m, Occupant side) {
     string notation;
     char teamChar = (side == Occupant::BLACK ? 'b' : 'w');
+    array<int, Move::MAX_GROUP_SIZE> group;
+    int groupSize = m.getMarbles(group);
     vector<string> cellNotations;
-    for (int idx : m.marbleIndices) {
-        cellNotations.push_back(indexToNotation(idx));
+    for (int i = 0; i < groupSize; i++) {
+        cellNotations.push_back(indexToNotation(group[i]));
     }
     sort(cellNotations.begin(), cellNotations.end(), greater<string>());
     notation = "(";
@@ -387,13 +356,63 @@ string Board::moveToNotation(const Move& m, Occupant side) {
         notation += cellNotations[i];
     }
     notation += ") ";
-    notation += (m.isInline ? "i" : "s");
+    notation += (m.isInline() ? "i" : "s");
     notation += " → ";
     static const char* DIRS[] = { "W", "E", "NW", "NE", "SW", "SE" };
-    notation += DIRS[m.direction];
+    notation += DIRS[m.direction()];
     return notation;
 }
 
+Move Board::moveFromNotation(const string& notation) const {
+    // "(side, cell, ...) type → direction"
+    size_t open = notation.find('(');
+    size_t close = notation.find(')', open);
+    if (open == string::npos || close == string::npos) {
+        return Move();
+    }
+    vector<string> tokens;
+    stringstream inner(notation.substr(open + 1, close - open - 1));
+    string token;
+    while (getline(inner, token, ',')) {
+        token.erase(remove_if(token.begin(), token.end(), [](unsigned char c) { return isspace(c); }), token.end());
+        tokens.push_back(token);
+    }
+    if (tokens.size() < 2 || tokens.size() > 1 + Move::MAX_GROUP_SIZE) {
+        return Move();
+    }
+    char teamChar = (nextToMove == Occupant::BLACK ? 'b' : 'w');
+    if (tokens[0].size() != 1 || tolower(static_cast<unsigned char>(tokens[0][0])) != teamChar) {
+        return Move();
+    }
+    vector<int> cells;
+    for (size_t i = 1; i < tokens.size(); i++) {
+        int index = notationToIndex(tokens[i]);
+        if (index < 0) {
+            return Move();
+        }
+        cells.push_back(index);
+    }
+    sort(cells.begin(), cells.end());
+
+    // The direction is the last word.
+    string direction;
+    stringstream rest(notation.substr(close + 1));
+    while (rest >> token) {
+        direction = token;
+    }
+    static const char* DIRS[] = { "W", "E", "NW", "NE", "SW", "SE" };
+
+    for (const Move& m : generateMoves(nextToMove)) {
+        array<int, Move::MAX_GROUP_SIZE> group;
+        int groupSize = m.getMarbles(group);
+        if (direction == DIRS[m.direction()] && groupSize == static_cast<int>(cells.size()) &&
+            equal(cells.begin(), cells.end(), group.begin())) {
+            return m;
+        }
+    }
+    return Move();
+}
+
 string Board::toBoardString() const {
     string result;
     bool first = true;
@@ -421,7 +440,7 @@ string Board::indexToNotation(int idx) {
 //========================== Hardcoded Layouts ==========================//
 
 void Board::initStandardLayout() {
-    occupant.fill(Occupant::EMPTY);
+    clear();
     vector<string> blackPositions = {
         "A1b", "A2b", "A3b", "A4b", "A5b",
         "B1b", "B2b", "B3b", "B4b", "B5b", "B6b",
@@ -438,48 +457,48 @@ void Board::initStandardLayout() {
     for (auto& cell : whitePositions) {
         setOccupant(cell, Occupant::WHITE);
     }
-
-    updateOccupantCoordinates();
 }
 
 void Board::initBelgianDaisyLayout() {
-    occupant.fill(Occupant::EMPTY);
+    clear();
     vector<string> blackPositions = {
-        "C5","C6","D4","D7","E4","E7","F4","F7","G5","G6"
+        "A1b", "A2b", "B1b", "B2b", "B3b", "C2b", "C3b",
+        "G7b", "G8b", "H7b", "H8b", "H9b", "I8b", "I9b"
     };
     for (auto& cell : blackPositions) {
         setOccupant(cell, Occupant::BLACK);
     }
     vector<string> whitePositions = {
-        "C4","D3","E3","F3","G4","G7","D8","E8","F8","G8"
+        "A4w", "A5w", "B4w", "B5w", "B6w", "C5w", "C6w",
+        "G4w", "G5w", "H4w", "H5w", "H6w", "I5w", "I6w"
     };
     for (auto& cell : whitePositions) {
         setOccupant(cell, Occupant::WHITE);
     }
-    updateOccupantCoordinates();
 }
 
 void Board::initGermanDaisyLayout() {
-    occupant.fill(Occupant::EMPTY);
+    clear();
     vector<string> blackPositions = {
-        "B4","C4","D5","E5","F5","G5","H6"
+        "B1b", "B2b", "C1b", "C2b", "C3b", "D2b", "D3b",
+        "F7b", "F8b", "G7b", "G8b", "G9b", "H8b", "H9b"
     };
     for (auto& cell : blackPositions) {
         setOccupant(cell, Occupant::BLACK);
     }
     vector<string> whitePositions = {
-        "B5","C5","D4","E4","F4","G4","H5"
+        "B5w", "B6w", "C5w", "C6w", "C7w", "D6w", "D7w",
+        "F3w", "F4w", "G3w", "G4w", "G5w", "H4w", "H5w"
     };
     for (auto& cell : whitePositions) {
         setOccupant(cell, Occupant::WHITE);
     }
-    updateOccupantCoordinates();
 }
 
 //========================== Loading from Input File ==========================//
 
 bool Board::loadFromInputFile(const string& filename) {
-    occupant.fill(Occupant::EMPTY);
+    clear();
     ifstream fin(filename);
     if (!fin.is_open()) {
         cerr << "Error: could not open file: " << filename << "\n";
@@ -524,85 +543,15 @@ bool Board::loadFromInputFile(const string& filename) {
         token.pop_back();
         setOccupant(token, who);
     }
-
-    updateOccupantCoordinates();
     fin.close();
     return true;
 }
 
 
-void Board::updateOccupantCoordinates() {
-    blackOccupantsCoords.clear();
-    whiteOccupantsCoords.clear();
-
-    for (int i = 0; i < NUM_CELLS; i++) {
-        if (occupant[i] == Occupant::BLACK) {
-            blackOccupantsCoords.push_back(s_indexToCoord[i]);
-        } else if (occupant[i] == Occupant::WHITE) {
-            whiteOccupantsCoords.push_back(s_indexToCoord[i]);
-        }
-    }
-
-    // Sort the lists to maintain order from A1 to A5, B1 to B6, etc.
-    auto sortingLambda = [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
-        return (a.second == b.second) ? (a.first < b.first) : (a.second < b.second);
-    };
-
-    std::sort(blackOccupantsCoords.begin(), blackOccupantsCoords.end(), sortingLambda);
-    std::sort(whiteOccupantsCoords.begin(), whiteOccupantsCoords.end(), sortingLambda);
-}
-
-
-void Board::updateOccupantCoordinates(int oldIndex, int newIndex, Occupant occupantType) {
-    std::vector<std::pair<int, int>>* targetList = nullptr;
-
-    if (occupantType == Occupant::BLACK) {
-        targetList = &blackOccupantsCoords;
-    } else if (occupantType == Occupant::WHITE) {
-        targetList = &whiteOccupantsCoords;
-    }
-
-    if (targetList) {
-        // Remove the old coordinate if valid
-        if (oldIndex >= 0) {
-            std::pair<int, int> oldCoord = s_indexToCoord[oldIndex];
-            auto it = std::lower_bound(targetList->begin(), targetList->end(), oldCoord,
-                [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
-                    return (a.second == b.second) ? (a.first < b.first) : (a.second < b.second);
-                });
-            if (it != targetList->end() && *it == oldCoord) {
-                targetList->erase(it);
-            }
-        }
-
-        // Insert the new coordinate in the correct position
-        if (newIndex >= 0) {
-            std::pair<int, int> newCoord = s_indexToCoord[newIndex];
-            auto it = std::lower_bound(targetList->begin(), targetList->end(), newCoord,
-                [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
-                    return (a.second == b.second) ? (a.first < b.first) : (a.second < b.second);
-                });
-
-            // Ensure we are not inserting duplicates
-            if (it == targetList->end() || *it != newCoord) {
-                targetList->insert(it, newCoord);  // Insert in sorted position
-            }
-        }
-    }
-}
-
-
-
-
-void Board::setOccupant(const string& notation, Occupant who, bool updateCoords) {
+void Board::setOccupant(const string& notation, Occupant who) {
     int idx = notationToIndex(notation);
     if (idx >= 0) {
-        occupant[idx] = who;
-
-        // Only update coordinates if updateCoords is true
-        if (updateCoords) {
-            updateOccupantCoordinates(idx, -1, who);  // -1 means we're just adding, no removal needed
-        }
+        setCell(idx, who);
     }
     else {
         cerr << "Warning: invalid cell notation '" << notation << "'\n";
@@ -612,74 +561,23 @@ void Board::setOccupant(const string& notation, Occupant who, bool updateCoords)
 
 
 
-//========================== Mapping, Neighbors, etc. ==========================//
-
-bool Board::s_mappingInitialized = false;
-unordered_map<long long, int> Board::s_coordToIndex;
-array<pair<int, int>, Board::NUM_CELLS> Board::s_indexToCoord;
-
+//========================== Board State ==========================//
 
-// static long long packCoord(int m, int y) {
-//     return (static_cast<long long>(m) << 32) ^ (static_cast<long long>(y) & 0xffffffff);
-// }
-
-void Board::initMapping() {
-    if (s_mappingInitialized) return;
-    s_mappingInitialized = true;
-    s_coordToIndex.clear();
-    int idx = 0;
-    for (int y = 1; y <= 9; ++y) {
-        for (int m = 1; m <= 9; ++m) {
-            bool validCell = false;
-            switch (y) {
-            case 1: validCell = (m >= 1 && m <= 5); break;
-            case 2: validCell = (m >= 1 && m <= 6); break;
-            case 3: validCell = (m >= 1 && m <= 7); break;
-            case 4: validCell = (m >= 1 && m <= 8); break;
-            case 5: validCell = (m >= 1 && m <= 9); break;
-            case 6: validCell = (m >= 2 && m <= 9); break;
-            case 7: validCell = (m >= 3 && m <= 9); break;
-            case 8: validCell = (m >= 4 && m <= 9); break;
-            case 9: validCell = (m >= 5 && m <= 9); break;
-            }
-            if (validCell) {
-                long long key = packCoord(m, y);
-                s_coordToIndex[key] = idx;
-                s_indexToCoord[idx] = { m, y };
-                ++idx;
-            }
+Board::Board(const std::array<uint64_t, 2>& marbles, Occupant toMove) {
+    clear();
+    for (int s = 0; s < 2; s++) {
+        Occupant who = (s == 0) ? Occupant::BLACK : Occupant::WHITE;
+        for (uint64_t bits = marbles[s] & BOARD_MASK; bits; bits &= bits - 1) {
+            setCell(lowestSetBit(bits), who);
         }
     }
-    if (idx != NUM_CELLS) {
-        throw runtime_error("Did not fill exactly 61 cells! Check your loops!");
-    }
+    nextToMove = toMove;
 }
 
-Board::Board() {
-    initMapping();
+void Board::clear() {
     occupant.fill(Occupant::EMPTY);
-    initNeighbors();
-}
-
-void Board::initNeighbors() {
-    for (int i = 0; i < NUM_CELLS; ++i) {
-        int m = s_indexToCoord[i].first;
-        int y = s_indexToCoord[i].second;
-        for (int d = 0; d < NUM_DIRECTIONS; ++d) {
-            int dm = DIRECTION_OFFSETS[d].first;
-            int dy = DIRECTION_OFFSETS[d].second;
-            int nm = m + dm;
-            int ny = y + dy;
-            long long nkey = packCoord(nm, ny);
-            auto it = s_coordToIndex.find(nkey);
-            if (it == s_coordToIndex.end()) {
-                neighbors[i][d] = -1;
-            }
-            else {
-                neighbors[i][d] = it->second;
-            }
-        }
-    }
+    bitboards = { 0, 0 };
+    zobristKey = 0;
 }
 
 int Board::notationToIndex(const string& notation) {
@@ -701,10 +599,5 @@ int Board::notationToIndex(const string& notation) {
     if (m < 1 || m > 9) {
         return -1;
     }
-    long long key = packCoord(m, y);
-    auto it = s_coordToIndex.find(key);
-    if (it == s_coordToIndex.end()) {
-        return -1;
-    }
-    return it->second;
+    return BoardGeometry::COORD_TO_INDEX[y][m];
 }
@@ -2,13 +2,20 @@
 #define ABALONE_BOARD_H
 
 #include <array>
+#include <cstdint>
 #include <string>
-#include <unordered_map>
 #include <vector>
 #include <set>
 #include <algorithm>
 #include <unordered_set>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "BoardGeometry.h"
+#include "Zobrist.h"
+
 //------------------------------------------------------------------------------
 // Occupant and Move Structures
 //------------------------------------------------------------------------------
@@ -16,49 +23,122 @@
 struct VectorHash;
 
 // Simple occupant type: empty, black, or white.
-enum class Occupant {
+enum class Occupant : uint8_t {
     EMPTY = 0,
     BLACK,
     WHITE
 };
 
-// Structure to represent a move.
-// 'marbleIndices' holds the indices of the marbles to be moved.
-// 'direction' is an integer from 0 to 5 corresponding to a movement direction.
-// 'isInline' indicates whether the move is inline (true) or a sidestep (false).
-// 'pushCount' can store how many opponent marbles are pushed.
+// Structure to represent a move, packed into a single 32-bit word so that
+// moves can be copied, stored and compared without any heap allocation.
+// A group is always a straight line, so it is fully described by its lowest
+// cell index (the anchor), its length and its axis.
+//   bits 0-5   anchor cell index (0..60)
+//   bits 6-7   group length (1..3); 0 marks the null move
+//   bits 8-9   group axis as (direction - 1): 0 = E, 1 = NW, 2 = NE
+//   bits 10-12 movement direction (0..5)
+//   bit  13    inline (true) or side-step (false)
+//   bits 14-15 how many opponent marbles are pushed
 struct Move {
-    std::vector<int> marbleIndices;
-    int direction;
-    bool isInline;
-    int pushCount;
+    static const int MAX_GROUP_SIZE = 3;
+
+    uint32_t code;
+
+    // The default move is the null move (no marbles).
+    Move() : code(0) {}
+
+    // 'axis' is the direction from the anchor to the next marble (E, NW or NE);
+    // it is ignored for single marbles.
+    Move(int anchor, int length, int axis, int direction, bool isInline, int pushCount)
+        : code(static_cast<uint32_t>(anchor)
+               | (static_cast<uint32_t>(length) << 6)
+               | (static_cast<uint32_t>(length > 1 ? axis - 1 : 0) << 8)
+               | (static_cast<uint32_t>(direction) << 10)
+               | (static_cast<uint32_t>(isInline ? 1 : 0) << 13)
+               | (static_cast<uint32_t>(pushCount) << 14)) {}
+
+    int anchor() const { return code & 0x3F; }
+    int length() const { return (code >> 6) & 0x3; }
+    int axis() const { return static_cast<int>((code >> 8) & 0x3) + 1; }
+    int direction() const { return (code >> 10) & 0x7; }
+    bool isInline() const { return (code >> 13) & 0x1; }
+    int pushCount() const { return (code >> 14) & 0x3; }
+    bool isNull() const { return code == 0; }
+
+    // Writes the indices of the moved marbles (ascending) and returns how many there are.
+    int getMarbles(std::array<int, MAX_GROUP_SIZE>& cells) const;
 
     bool operator==(const Move& other) const {
-        return (marbleIndices == other.marbleIndices &&
-                direction == other.direction &&
-                isInline == other.isInline &&
-                pushCount == other.pushCount);
+        return code == other.code;
+    }
+
+    bool operator!=(const Move& other) const {
+        return code != other.code;
     }
 };
 
+// Fixed-capacity move container used by move generation and search.
+class MoveList {
+public:
+    // Upper bound on legal moves: one per (line of 1-3 cells, direction) pair
+    // on the 61-cell board (61 + 156 + 129 lines, 6 directions each).
+    static const int CAPACITY = BoardGeometry::NUM_DIRECTIONS * BoardGeometry::NUM_SEGMENTS;
+
+    MoveList() : m_size(0) {}
+
+    void push_back(const Move& move) { m_moves[m_size++] = move; }
+    void clear() { m_size = 0; }
+
+    int size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    Move& operator[](int i) { return m_moves[i]; }
+    const Move& operator[](int i) const { return m_moves[i]; }
+
+    Move* begin() { return m_moves.data(); }
+    Move* end() { return m_moves.data() + m_size; }
+    const Move* begin() const { return m_moves.data(); }
+    const Move* end() const { return m_moves.data() + m_size; }
+
+private:
+    std::array<Move, CAPACITY> m_moves;
+    int m_size;
+};
+
+// One cell changed by a move: its index and the occupant before and after.
+struct CellChange {
+    int8_t cell;
+    Occupant before;
+    Occupant after;
+};
+
+// Undo record returned by Board::makeMove. A move changes at most six cells
+// (a side-step of three marbles); an inline move changes at most three
+// (the tail, the cell in front and the end of a pushed chain).
+struct UndoInfo {
+    static const int MAX_CHANGES = 2 * Move::MAX_GROUP_SIZE;
+
+    std::array<CellChange, MAX_CHANGES> changes;
+    int count;
+};
+
 //------------------------------------------------------------------------------
 // Board Class Declaration
 //------------------------------------------------------------------------------
 
 class Board {
 public:
-    static const int NUM_CELLS = 61;     // Exactly 61 valid positions.
-    static const int NUM_DIRECTIONS = 6;   // Directions: W, E, NW, NE, SW, SE.
+    static const int NUM_CELLS = BoardGeometry::NUM_CELLS;           // Exactly 61 valid positions.
+    static const int NUM_DIRECTIONS = BoardGeometry::NUM_DIRECTIONS; // Directions: W, E, NW, NE, SW, SE.
 
-    // Arrays to track player coordinates
-    std::vector<std::pair<int, int>> blackOccupantsCoords;
-    std::vector<std::pair<int, int>> whiteOccupantsCoords;
-
-    static std::unordered_map<long long, int> s_coordToIndex;
+    // Bit i of a bitboard corresponds to cell index i; 61 cells fit in one word.
+    static constexpr uint64_t BOARD_MASK = BoardGeometry::BOARD_MASK;
 
     // Direction offsets (dx, dy) in board coordinates.
     // Order: W=(-1,0), E=(+1,0), NW=(0,+1), NE=(+1,+1), SW=(-1,-1), SE=(0,-1)
-    static const std::array<std::pair<int, int>, NUM_DIRECTIONS> DIRECTION_OFFSETS;
+    static constexpr std::array<std::pair<int, int>, NUM_DIRECTIONS> DIRECTION_OFFSETS = { {
+        {-1,  0}, {+1,  0}, { 0, +1}, {+1, +1}, {-1, -1}, { 0, -1}
+    } };
 
     // Next-to-move color.
     Occupant nextToMove = Occupant::BLACK;
@@ -66,21 +146,40 @@ public:
     // Board representation: occupant[i] tells who occupies cell index i.
     std::array<Occupant, NUM_CELLS> occupant;
 
+    // Bitboard representation kept in sync with occupant[]:
+    // bitboards[0] holds the black marbles, bitboards[1] the white marbles.
+    std::array<uint64_t, 2> bitboards;
+
+    // Zobrist hash of the marbles only, kept in sync with occupant[] by every write.
+    // The side to move is folded in by hash().
+    uint64_t zobristKey = 0;
 
+    // The geometry tables are compile-time constants (see BoardGeometry.h);
+    // these aliases keep the existing Board:: spellings.
 
     // Neighbors table: for each cell i, neighbors[i][d] gives the neighbor's index in
     // direction d (or -1 if none exists).
-    std::array<std::array<int, NUM_DIRECTIONS>, NUM_CELLS> neighbors;
+    static constexpr const auto& neighbors = BoardGeometry::NEIGHBORS;
 
     // Reverse mapping: cell index to coordinate (m,y).
-    static std::array<std::pair<int, int>, NUM_CELLS> s_indexToCoord;
+    static constexpr const auto& s_indexToCoord = BoardGeometry::INDEX_TO_COORD;
+
+    // Bitboard of all cells with at least one off-board direction.
+    static constexpr uint64_t s_edgeMask = BoardGeometry::EDGE_MASK;
+
+    // s_neighborMasks[i] has a bit set for every on-board neighbor of cell i.
+    static constexpr const auto& s_neighborMasks = BoardGeometry::NEIGHBOR_MASKS;
 
     //--------------------------------------------------------------------------
     // Public Methods and Constructors
     //--------------------------------------------------------------------------
 
-    // Constructor: initializes coordinate mapping and neighbor table.
-    Board();
+    // Constructor: an empty board with black to move.
+    Board() { clear(); }
+
+    // The position with the given bitboards (black, white), which must not
+    // overlap; bits outside the board are ignored.
+    Board(const std::array<uint64_t, 2>& marbles, Occupant toMove);
 
     // Static function: Converts a board cell's string notation (e.g., "A1", "H5")
     // to its corresponding cell index (0..60). Returns -1 if the notation is invalid.
@@ -91,34 +190,41 @@ public:
 
     bool isGroupAligned(const std::vector<int> &group, int &alignedDirection) const;
 
-    // Attempts to apply a move on a temporary copy of the board.
-    // Returns true if the move is legal (applied without error), false otherwise.
-    bool tryMove(const std::vector<int>& group, int direction, Move& move) const;
-
-    // Generate candidate column groups for the given side.
-    std::set<std::vector<int>> generateColumnGroups(Occupant side) const;
+    // Returns true if 'move' is legal for the side that owns its marbles, including
+    // a matching inline flag and push count. Never throws and never copies the board.
+    bool isLegalMove(const Move& move) const;
 
+    // Returns true if 'move' (legal in this position) pushes an opponent marble off the board.
+    bool isCaptureMove(const Move& move) const;
 
     // Generate all legal moves for a given side.
-    std::vector<Move> generateMoves(Occupant side) const;
+    MoveList generateMoves(Occupant side) const;
 
     // Apply a move to *this* board (modifies occupant[]).
+    // The move is trusted to be legal (e.g. produced by generateMoves) and is not validated.
     void applyMove(const Move& m);
 
+    // Checked variant for untrusted input (files, the Python bridge):
+    // throws std::runtime_error if the move is not legal in this position.
+    void applyMoveChecked(const Move& m);
+
+    // Search interface: applies a trusted move in place, passes the turn to the
+    // other side and returns the cells that changed (including pushed-off marbles).
+    UndoInfo makeMove(const Move& m);
+
+    // Restores the position from before the makeMove that returned 'undo'.
+    void unmakeMove(const UndoInfo& undo);
+
+    // Null-move pruning: passes the turn without moving; undone by calling it again.
+    void makeNullMove() {
+        nextToMove = (nextToMove == Occupant::BLACK) ? Occupant::WHITE : Occupant::BLACK;
+    }
+
     bool isMarbleInDanger(int index, Occupant player) const {
         Occupant opponent = (player == Occupant::BLACK) ? Occupant::WHITE : Occupant::BLACK;
         
-        // First check if the marble is on the edge
-        bool isOnEdge = false;
-        for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
-            if (neighbors[index][dir] == -1) {
-                isOnEdge = true;
-                break;
-            }
-        }
-        
         // If not on edge, it's not in immediate danger of being pushed off
-        if (!isOnEdge) {
+        if (!isEdgeCell(index)) {
             return false;
         }
         
@@ -160,11 +266,11 @@ public:
     
 
     bool isPushMove(const Move& move, Occupant player) const {
-        if (!move.isInline || move.marbleIndices.empty())
+        if (!move.isInline() || move.isNull())
             return false;
     
-        int front = getFrontCell(move.marbleIndices, move.direction);
-        int neighbor = neighbors[front][move.direction];
+        int front = getFrontCell(move);
+        int neighbor = neighbors[front][move.direction()];
     
         if (neighbor == -1)
             return false;
@@ -176,11 +282,11 @@ public:
         // Count opponent marbles in the push direction
         while (curr != -1 && occupant[curr] == opp && pushableCount < 3) {
             pushableCount++;
-            curr = neighbors[curr][move.direction];
+            curr = neighbors[curr][move.direction()];
         }
     
         // Our group must be stronger than the number of opponent marbles
-        if (pushableCount == 0 || move.marbleIndices.size() <= pushableCount)
+        if (pushableCount == 0 || move.length() <= pushableCount)
             return false;
     
         // Condition 1: Are we pushing a marble off the board?
@@ -201,7 +307,7 @@ public:
                 return true;  // Low-risk positional gain
             else {
                 // Avoid risky trades unless we outnumber clearly
-                return move.marbleIndices.size() >= 3 && pushableCount == 2;
+                return move.length() >= 3 && pushableCount == 2;
             }
         }
     
@@ -210,13 +316,19 @@ public:
     }    
     
 
-    // Returns the index of the marble in 'group' that is furthest in the given direction.
+    // Returns the index of the moved marble that is furthest in the move's direction.
     // Uses the dot product with the direction offset to decide which marble is the "front."
-    int getFrontCell(const std::vector<int>& group, int direction) const;
+    int getFrontCell(const Move& move) const;
 
     // Converts a move into document notation (e.g., "(b, C5, D5) i → NW").
     static std::string moveToNotation(const Move& m, Occupant side);
 
+    // The legal move of the side to move written in document notation. The
+    // marbles may be listed in any order; the move type (i/s) follows from the
+    // marbles and direction and is not checked. Returns the null move if the
+    // notation names no legal move of nextToMove.
+    Move moveFromNotation(const std::string& notation) const;
+
     // Returns a string representing the board state (e.g., "C5b,D5b,E4b,...").
     std::string toBoardString() const;
 
@@ -231,12 +343,12 @@ public:
     bool loadFromInputFile(const std::string& filename);
 
     // Sets the occupant of a cell given its board notation.
-    void setOccupant(const std::string& notation, Occupant who, bool updateCoords = false);
+    void setOccupant(const std::string& notation, Occupant who);
 
     // Helper: Sets the occupant of a cell by its index.
     void setOccupant(int index, Occupant who) {
         if (index >= 0 && index < NUM_CELLS) {
-            occupant[index] = who;
+            setCell(index, who);
         }
     }
 
@@ -245,51 +357,111 @@ public:
         return (index >= 0 && index < NUM_CELLS) ? occupant[index] : Occupant::EMPTY;
     }
 
-private:
+    // Removes every marble from the board.
+    void clear();
+
     //--------------------------------------------------------------------------
-    // Static Mapping and Neighbor Calculation
+    // Bitboard Queries
     //--------------------------------------------------------------------------
 
-    // Flag to indicate if the coordinate mapping has been initialized.
-    static bool s_mappingInitialized;
-    // Mapping from a packed coordinate (m,y) to a cell index.
+    // Returns the bitboard of the given side's marbles (0 for EMPTY).
+    uint64_t getBitboard(Occupant side) const {
+        if (side == Occupant::BLACK) return bitboards[0];
+        if (side == Occupant::WHITE) return bitboards[1];
+        return 0;
+    }
+
+    // Returns the bitboard of all empty cells.
+    uint64_t getEmptyBitboard() const {
+        return BOARD_MASK & ~(bitboards[0] | bitboards[1]);
+    }
 
+    // The bitboards this position would have after the trusted move 'm', without applying it.
+    std::array<uint64_t, 2> bitboardsAfter(const Move& m) const;
 
-    // Initializes the coordinate mapping.
-    static void initMapping();
+    // Zobrist hash of the position including the side to move.
+    uint64_t hash() const {
+        return (nextToMove == Occupant::WHITE) ? (zobristKey ^ Zobrist::SIDE_TO_MOVE_KEY) : zobristKey;
+    }
+
+    // Number of marbles the given side has on the board.
+    int countMarbles(Occupant side) const {
+        return popcount(getBitboard(side));
+    }
 
-    // Builds the neighbor table using the coordinate mapping.
-    void initNeighbors();
+    // True if the cell has at least one off-board direction.
+    static bool isEdgeCell(int index) {
+        return (s_edgeMask >> index) & 1ULL;
+    }
 
-    void updateOccupantCoordinates();
+    // Returns the opposite direction (W<->E, NW<->SE, NE<->SW).
+    static int oppositeDirection(int direction) {
+        return BoardGeometry::OPPOSITE_DIRECTION[direction];
+    }
 
-    void updateOccupantCoordinates(int oldIndex, int newIndex, Occupant occupantType);
+    // Moves every set bit one step in the given direction; bits that would
+    // leave the board are dropped. The result is the set of d-neighbors of 'bits'.
+    static uint64_t shiftBitboard(uint64_t bits, int direction) {
+        uint64_t result = 0;
+        for (const BoardGeometry::RowShift& row : BoardGeometry::ROW_SHIFTS[direction]) {
+            uint64_t src = bits & row.mask;
+            result |= (row.shift >= 0) ? (src << row.shift) : (src >> -row.shift);
+        }
+        return result;
+    }
 
+    // Portable 64-bit population count.
+    static int popcount(uint64_t bits) {
+#if defined(_MSC_VER)
+        return static_cast<int>(__popcnt64(bits));
+#else
+        return __builtin_popcountll(bits);
+#endif
+    }
 
-    //--------------------------------------------------------------------------
-    // Group Generation and Alignment Helpers
-    //--------------------------------------------------------------------------
+    // Index of the lowest set bit; 'bits' must be non-zero.
+    static int lowestSetBit(uint64_t bits) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
 
-    // Recursively collects all connected groups (up to size 3) of marbles of a given side,
-    // starting from cell 'current'. The current group is stored in 'group', and valid groups
-    // are inserted into 'result'.
-    void dfsGroup(int current, Occupant side, std::vector<int>& group,
-        std::set<std::vector<int>>& result) const;
+private:
+    // Writes a cell in both representations and updates the hash.
+    void setCell(int index, Occupant who) {
+        zobristKey ^= Zobrist::CELL_KEYS[index][static_cast<int>(occupant[index])]
+                    ^ Zobrist::CELL_KEYS[index][static_cast<int>(who)];
+        uint64_t bit = 1ULL << index;
+        bitboards[0] &= ~bit;
+        bitboards[1] &= ~bit;
+        if (who == Occupant::BLACK) bitboards[0] |= bit;
+        else if (who == Occupant::WHITE) bitboards[1] |= bit;
+        occupant[index] = who;
+    }
 
-    void scanCoordinateSet(const std::vector<std::vector<std::pair<int, int>>>& coordinateSet,
-                              Occupant side, std::set<std::vector<int>>& groupSet, int d, bool isHorizontal) const;
+    // Computes the cells a legal move changes and their new occupants.
+    // Returns the number of entries written to 'changes'.
+    int collectChanges(const Move& m, std::array<CellChange, UndoInfo::MAX_CHANGES>& changes) const;
 
 
-    void scanHorizontal(const std::vector<std::vector<std::pair<int, int>>> &coordinateSet, Occupant side, int d,
-                        std::set<std::vector<int>> &groups) const;
+    //--------------------------------------------------------------------------
+    // Group Generation and Alignment Helpers
+    //--------------------------------------------------------------------------
 
-    void scanNorthEast(const std::vector<std::vector<std::pair<int, int>>> &coordinateSet, Occupant side, int d,
-                       std::set<std::vector<int>> &groups) const;
+    // Builds the move of the line group (anchor, length, axis) in 'direction' using
+    // neighbor lookups only. Returns false, leaving 'move' untouched, if it is illegal for 'side'.
+    bool buildMove(int anchor, int length, int axis, int direction, Occupant side, Move& move) const;
 
-    void scanNorthWest(const std::vector<std::vector<std::pair<int, int>>> &coordinateSet, Occupant side, int d,
-                       std::set<std::vector<int>> &groups) const;
+    // Buffer of candidate groups filled by generateGroups.
+    using GroupBuffer = std::array<const BoardGeometry::Segment*, BoardGeometry::NUM_SEGMENTS>;
 
-    std::set<std::vector<int>> generateGroups(Occupant side) const;
+    // Writes every segment fully occupied by 'side' to 'groups', ordered by anchor
+    // and then by the segment's cell list. Returns how many were written.
+    int generateGroups(Occupant side, GroupBuffer& groups) const;
 
 
     //--------------------------------------------------------------------------
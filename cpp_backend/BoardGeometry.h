@@ -0,0 +1,423 @@
+#ifndef ABALONE_BOARD_GEOMETRY_H
+#define ABALONE_BOARD_GEOMETRY_H
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+//------------------------------------------------------------------------------
+// Compile-time Board Geometry
+//------------------------------------------------------------------------------
+//
+// Every table here is generated by the compiler and shared by all boards.
+// Cells are numbered row by row: A1..A5 = 0..4, B1..B6 = 5..10, ..., I5..I9 = 56..60.
+// A coordinate (m, y) is the diagonal number m (1..9) and the row y (1..9 = A..I).
+
+namespace BoardGeometry {
+
+constexpr int NUM_CELLS = 61;
+constexpr int NUM_DIRECTIONS = 6;
+constexpr int NUM_ROWS = 9;
+
+// Direction offsets in (dm, dy) form.
+// Order: W=(-1,0), E=(+1,0), NW=(0,+1), NE=(+1,+1), SW=(-1,-1), SE=(0,-1)
+constexpr int DIRECTION_DM[NUM_DIRECTIONS] = { -1, +1, 0, +1, -1, 0 };
+constexpr int DIRECTION_DY[NUM_DIRECTIONS] = { 0, 0, +1, +1, -1, -1 };
+
+// OPPOSITE_DIRECTION[d] points the other way (W<->E, NW<->SE, NE<->SW).
+constexpr std::array<int, NUM_DIRECTIONS> OPPOSITE_DIRECTION = { 1, 0, 5, 4, 3, 2 };
+
+// The centre cell E5.
+constexpr int CENTER_M = 5;
+constexpr int CENTER_Y = 5;
+
+//--------------------------------------------------------------------------
+// Coordinate helpers
+//--------------------------------------------------------------------------
+
+// First and last diagonal number present in row y.
+constexpr int rowMin(int y) { return y <= 5 ? 1 : y - 4; }
+constexpr int rowMax(int y) { return y <= 5 ? y + 4 : 9; }
+
+// Index of the first cell of row y.
+constexpr int rowStart(int y) {
+    int start = 0;
+    for (int r = 1; r < y; ++r) {
+        start += rowMax(r) - rowMin(r) + 1;
+    }
+    return start;
+}
+
+// Cell index of (m, y), or -1 if the coordinate is off the board.
+constexpr int coordToIndex(int m, int y) {
+    if (y < 1 || y > NUM_ROWS || m < rowMin(y) || m > rowMax(y)) {
+        return -1;
+    }
+    return rowStart(y) + (m - rowMin(y));
+}
+
+// Row (1..9) of a cell index.
+constexpr int cellRow(int index) {
+    int y = 1;
+    while (y < NUM_ROWS && rowStart(y + 1) <= index) {
+        ++y;
+    }
+    return y;
+}
+
+// Diagonal number (1..9) of a cell index.
+constexpr int cellDiagonal(int index) {
+    int y = cellRow(index);
+    return rowMin(y) + (index - rowStart(y));
+}
+
+constexpr int absValue(int v) { return v < 0 ? -v : v; }
+
+// Hex distance between two coordinates in this (m, y) system.
+constexpr int hexDistance(int m1, int y1, int m2, int y2) {
+    int dm = m1 - m2;
+    int dy = y1 - y2;
+    return (absValue(dm) + absValue(dy) + absValue(dm - dy)) / 2;
+}
+
+//--------------------------------------------------------------------------
+// Table builders
+//--------------------------------------------------------------------------
+
+namespace detail {
+
+template <std::size_t... I>
+constexpr std::array<std::pair<int, int>, NUM_CELLS> makeIndexToCoord(std::index_sequence<I...>) {
+    return { { std::pair<int, int>(cellDiagonal(static_cast<int>(I)), cellRow(static_cast<int>(I)))... } };
+}
+
+// Indexed [y][m] with a border of -1 so that one step off the board is still in range.
+constexpr std::array<std::array<int8_t, NUM_ROWS + 2>, NUM_ROWS + 2> makeCoordToIndex() {
+    std::array<std::array<int8_t, NUM_ROWS + 2>, NUM_ROWS + 2> table{};
+    for (int y = 0; y < NUM_ROWS + 2; ++y) {
+        for (int m = 0; m < NUM_ROWS + 2; ++m) {
+            table[y][m] = static_cast<int8_t>(coordToIndex(m, y));
+        }
+    }
+    return table;
+}
+
+constexpr std::array<std::array<int, NUM_DIRECTIONS>, NUM_CELLS> makeNeighbors() {
+    std::array<std::array<int, NUM_DIRECTIONS>, NUM_CELLS> table{};
+    for (int i = 0; i < NUM_CELLS; ++i) {
+        for (int d = 0; d < NUM_DIRECTIONS; ++d) {
+            table[i][d] = coordToIndex(cellDiagonal(i) + DIRECTION_DM[d], cellRow(i) + DIRECTION_DY[d]);
+        }
+    }
+    return table;
+}
+
+constexpr std::array<uint64_t, NUM_CELLS> makeNeighborMasks() {
+    std::array<uint64_t, NUM_CELLS> masks{};
+    for (int i = 0; i < NUM_CELLS; ++i) {
+        for (int d = 0; d < NUM_DIRECTIONS; ++d) {
+            int n = coordToIndex(cellDiagonal(i) + DIRECTION_DM[d], cellRow(i) + DIRECTION_DY[d]);
+            if (n >= 0) {
+                masks[i] |= 1ULL << n;
+            }
+        }
+    }
+    return masks;
+}
+
+constexpr uint64_t makeEdgeMask() {
+    uint64_t mask = 0;
+    for (int i = 0; i < NUM_CELLS; ++i) {
+        for (int d = 0; d < NUM_DIRECTIONS; ++d) {
+            if (coordToIndex(cellDiagonal(i) + DIRECTION_DM[d], cellRow(i) + DIRECTION_DY[d]) < 0) {
+                mask |= 1ULL << i;
+            }
+        }
+    }
+    return mask;
+}
+
+constexpr std::array<int, NUM_CELLS> makeCenterDistance() {
+    std::array<int, NUM_CELLS> table{};
+    for (int i = 0; i < NUM_CELLS; ++i) {
+        table[i] = hexDistance(cellDiagonal(i), cellRow(i), CENTER_M, CENTER_Y);
+    }
+    return table;
+}
+
+constexpr std::array<int, NUM_CELLS> makeEdgeDistance() {
+    std::array<int, NUM_CELLS> table{};
+    for (int i = 0; i < NUM_CELLS; ++i) {
+        table[i] = 4 - hexDistance(cellDiagonal(i), cellRow(i), CENTER_M, CENTER_Y);
+    }
+    return table;
+}
+
+} // namespace detail
+
+//--------------------------------------------------------------------------
+// Per-cell tables
+//--------------------------------------------------------------------------
+
+// Cell index -> (m, y).
+inline constexpr std::array<std::pair<int, int>, NUM_CELLS> INDEX_TO_COORD =
+    detail::makeIndexToCoord(std::make_index_sequence<NUM_CELLS>{});
+
+// COORD_TO_INDEX[y][m] -> cell index, or -1 (valid for 0 <= m, y <= 10).
+inline constexpr std::array<std::array<int8_t, NUM_ROWS + 2>, NUM_ROWS + 2> COORD_TO_INDEX =
+    detail::makeCoordToIndex();
+
+// NEIGHBORS[i][d] is the neighbor of cell i in direction d, or -1 if off the board.
+inline constexpr std::array<std::array<int, NUM_DIRECTIONS>, NUM_CELLS> NEIGHBORS = detail::makeNeighbors();
+
+// Bitboard of the on-board neighbors of each cell.
+inline constexpr std::array<uint64_t, NUM_CELLS> NEIGHBOR_MASKS = detail::makeNeighborMasks();
+
+// Bitboard of every cell and of the outer ring.
+inline constexpr uint64_t BOARD_MASK = (1ULL << NUM_CELLS) - 1;
+inline constexpr uint64_t EDGE_MASK = detail::makeEdgeMask();
+
+// Hex distance from E5 (0 = centre, 4 = outer ring) and its complement,
+// the number of steps to the outer ring (0 = on the edge).
+inline constexpr std::array<int, NUM_CELLS> CENTER_DISTANCE = detail::makeCenterDistance();
+inline constexpr std::array<int, NUM_CELLS> EDGE_DISTANCE = detail::makeEdgeDistance();
+
+//--------------------------------------------------------------------------
+// Directional bitboard shifts
+//--------------------------------------------------------------------------
+
+// Within one row every cell reaches its neighbor in a given direction by the
+// same index offset, so a directional shift is one masked shift per row.
+struct RowShift {
+    uint64_t mask;  // cells of the row that have a neighbor in this direction
+    int shift;      // index offset to that neighbor (negative = right shift)
+};
+
+namespace detail {
+
+constexpr std::array<std::array<RowShift, NUM_ROWS>, NUM_DIRECTIONS> makeRowShifts() {
+    std::array<std::array<RowShift, NUM_ROWS>, NUM_DIRECTIONS> table{};
+    for (int d = 0; d < NUM_DIRECTIONS; ++d) {
+        for (int y = 1; y <= NUM_ROWS; ++y) {
+            RowShift& row = table[d][y - 1];
+            row.mask = 0;
+            row.shift = 0;
+            for (int m = rowMin(y); m <= rowMax(y); ++m) {
+                int from = coordToIndex(m, y);
+                int to = coordToIndex(m + DIRECTION_DM[d], y + DIRECTION_DY[d]);
+                if (to >= 0) {
+                    row.mask |= 1ULL << from;
+                    row.shift = to - from;
+                }
+            }
+        }
+    }
+    return table;
+}
+
+} // namespace detail
+
+inline constexpr std::array<std::array<RowShift, NUM_ROWS>, NUM_DIRECTIONS> ROW_SHIFTS = detail::makeRowShifts();
+
+//--------------------------------------------------------------------------
+// Straight lines
+//--------------------------------------------------------------------------
+
+// The axes along which a group is listed: E, NW and NE all increase the cell index.
+constexpr int LINE_AXES[3] = { 1, 2, 3 };
+
+// Number of straight lines of 'length' cells on the board.
+constexpr int countLines(int length) {
+    int count = 0;
+    for (int i = 0; i < NUM_CELLS; ++i) {
+        for (int axis : LINE_AXES) {
+            int cell = i;
+            int k = 1;
+            while (k < length && cell >= 0) {
+                cell = coordToIndex(cellDiagonal(cell) + DIRECTION_DM[axis], cellRow(cell) + DIRECTION_DY[axis]);
+                ++k;
+            }
+            if (cell >= 0) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+namespace detail {
+
+// Lines in ascending lexicographic order of their (ascending) cell indices.
+template <int Length>
+constexpr std::array<std::array<int, Length>, countLines(Length)> makeLines() {
+    std::array<std::array<int, Length>, countLines(Length)> lines{};
+    int count = 0;
+    for (int i = 0; i < NUM_CELLS; ++i) {
+        for (int axis : LINE_AXES) {
+            std::array<int, Length> line{};
+            line[0] = i;
+            bool valid = true;
+            for (int k = 1; k < Length && valid; ++k) {
+                line[k] = coordToIndex(cellDiagonal(line[k - 1]) + DIRECTION_DM[axis],
+                                       cellRow(line[k - 1]) + DIRECTION_DY[axis]);
+                valid = line[k] >= 0;
+            }
+            if (valid) {
+                for (int k = 0; k < Length; ++k) {
+                    lines[count][k] = line[k];
+                }
+                ++count;
+            }
+        }
+    }
+    return lines;
+}
+
+} // namespace detail
+
+// All lines of two and three adjacent cells.
+inline constexpr auto LINES_OF_TWO = detail::makeLines<2>();
+inline constexpr auto LINES_OF_THREE = detail::makeLines<3>();
+
+// The lines of three (indices into LINES_OF_THREE) that pass through a cell:
+// at most three axes times three positions on the line.
+struct CellLines {
+    std::array<int, 9> lines;
+    int count;
+};
+
+namespace detail {
+
+constexpr std::array<CellLines, NUM_CELLS> makeLinesOfThreeThrough() {
+    std::array<CellLines, NUM_CELLS> table{};
+    for (int l = 0; l < static_cast<int>(LINES_OF_THREE.size()); ++l) {
+        for (int cell : LINES_OF_THREE[l]) {
+            table[cell].lines[table[cell].count++] = l;
+        }
+    }
+    return table;
+}
+
+constexpr std::array<uint64_t, countLines(3)> makeLineOfThreeMasks() {
+    std::array<uint64_t, countLines(3)> masks{};
+    for (int l = 0; l < static_cast<int>(LINES_OF_THREE.size()); ++l) {
+        for (int cell : LINES_OF_THREE[l]) {
+            masks[l] |= 1ULL << cell;
+        }
+    }
+    return masks;
+}
+
+} // namespace detail
+
+inline constexpr std::array<CellLines, NUM_CELLS> LINES_OF_THREE_THROUGH = detail::makeLinesOfThreeThrough();
+inline constexpr std::array<uint64_t, countLines(3)> LINE_OF_THREE_MASKS = detail::makeLineOfThreeMasks();
+
+//--------------------------------------------------------------------------
+// Group segments
+//--------------------------------------------------------------------------
+
+// Every group a player can move is a segment: a single cell or a line of two or three.
+constexpr int NUM_SEGMENTS = NUM_CELLS + countLines(2) + countLines(3);
+
+// A segment described the way a Move describes its group.
+struct Segment {
+    uint64_t mask;  // bitboard of the segment's cells
+    int anchor;     // lowest cell index
+    int length;     // 1..3
+    int axis;       // direction from the anchor to the next cell (E, NW or NE); 1 for single cells
+    // targets[d]: the cells the segment's marbles step onto in direction d,
+    // or 0 if any of them would leave the board.
+    std::array<uint64_t, NUM_DIRECTIONS> targets;
+};
+
+namespace detail {
+
+// Segments grouped by anchor. Within an anchor they are in ascending lexicographic
+// order of their cell lists (single cell first, then by second cell, shorter first),
+// which is the order move generation has always listed groups in.
+constexpr std::array<Segment, NUM_SEGMENTS> makeSegments() {
+    std::array<Segment, NUM_SEGMENTS> segments{};
+    std::array<int, NUM_SEGMENTS> order{};
+    int count = 0;
+    for (int i = 0; i < NUM_CELLS; ++i) {
+        int first = count;
+        segments[count] = Segment{ 1ULL << i, i, 1, 1, {} };
+        order[count++] = 0;
+        for (int axis : LINE_AXES) {
+            int second = coordToIndex(cellDiagonal(i) + DIRECTION_DM[axis], cellRow(i) + DIRECTION_DY[axis]);
+            int cell = i;
+            uint64_t mask = 1ULL << i;
+            for (int length = 2; length <= 3; ++length) {
+                cell = coordToIndex(cellDiagonal(cell) + DIRECTION_DM[axis], cellRow(cell) + DIRECTION_DY[axis]);
+                if (cell < 0) {
+                    break;
+                }
+                mask |= 1ULL << cell;
+                segments[count] = Segment{ mask, i, length, axis, {} };
+                order[count++] = second * 4 + length;
+            }
+        }
+
+        for (int k = first; k < count; ++k) {
+            for (int d = 0; d < NUM_DIRECTIONS; ++d) {
+                uint64_t targets = 0;
+                for (int cell = 0; cell < NUM_CELLS; ++cell) {
+                    if (!((segments[k].mask >> cell) & 1ULL)) {
+                        continue;
+                    }
+                    int target = coordToIndex(cellDiagonal(cell) + DIRECTION_DM[d], cellRow(cell) + DIRECTION_DY[d]);
+                    if (target < 0) {
+                        targets = 0;
+                        break;
+                    }
+                    targets |= 1ULL << target;
+                }
+                segments[k].targets[d] = targets;
+            }
+        }
+
+        // Insertion sort of this anchor's segments by (second cell, length).
+        for (int a = first + 1; a < count; ++a) {
+            for (int b = a; b > first && order[b - 1] > order[b]; --b) {
+                Segment segment = segments[b];
+                segments[b] = segments[b - 1];
+                segments[b - 1] = segment;
+                int key = order[b];
+                order[b] = order[b - 1];
+                order[b - 1] = key;
+            }
+        }
+    }
+    return segments;
+}
+
+constexpr std::array<int, NUM_CELLS + 1> makeSegmentBegin(const std::array<Segment, NUM_SEGMENTS>& segments) {
+    std::array<int, NUM_CELLS + 1> begin{};
+    int s = 0;
+    for (int i = 0; i <= NUM_CELLS; ++i) {
+        while (s < NUM_SEGMENTS && segments[s].anchor < i) {
+            ++s;
+        }
+        begin[i] = s;
+    }
+    return begin;
+}
+
+} // namespace detail
+
+inline constexpr std::array<Segment, NUM_SEGMENTS> SEGMENTS = detail::makeSegments();
+
+// Segments anchored at cell i are SEGMENTS[SEGMENT_BEGIN[i]] .. SEGMENTS[SEGMENT_BEGIN[i + 1] - 1].
+inline constexpr std::array<int, NUM_CELLS + 1> SEGMENT_BEGIN = detail::makeSegmentBegin(SEGMENTS);
+
+static_assert(coordToIndex(5, 1) == 4 && coordToIndex(5, 9) == 56 && coordToIndex(9, 9) == 60,
+              "Cell numbering must run row by row from A1 to I9");
+static_assert(LINES_OF_TWO.size() == 156 && LINES_OF_THREE.size() == 129,
+              "Unexpected number of lines on the 61-cell board");
+static_assert(NUM_SEGMENTS == 346 && SEGMENT_BEGIN[NUM_CELLS] == NUM_SEGMENTS,
+              "Every segment must be reachable from its anchor");
+
+} // namespace BoardGeometry
+
+#endif // ABALONE_BOARD_GEOMETRY_H
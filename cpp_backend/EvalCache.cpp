@@ -0,0 +1,47 @@
+#include "EvalCache.h"
+#include <algorithm>
+
+EvalCache::EvalCache(size_t sizeInKB) {
+    size_t entryCount = std::max<size_t>(1, (sizeInKB * 1024) / sizeof(uint64_t));
+    m_entryCount = 1;
+    while (m_entryCount * 2 <= entryCount) {
+        m_entryCount *= 2;
+    }
+    m_entries.reset(new std::atomic<uint64_t>[m_entryCount]);
+    clear();
+}
+
+void EvalCache::clear() {
+    for (size_t i = 0; i < m_entryCount; ++i) {
+        m_entries[i].store(0, std::memory_order_relaxed);
+    }
+    resetStats();
+}
+
+bool EvalCache::probe(uint64_t key, int& score) {
+    uint64_t word = entryFor(key).load(std::memory_order_relaxed);
+    m_probes.fetch_add(1, std::memory_order_relaxed);
+    if (static_cast<uint32_t>(word >> 32) != keyCheck(key)) {
+        return false;
+    }
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    score = static_cast<int32_t>(static_cast<uint32_t>(word));
+    return true;
+}
+
+void EvalCache::store(uint64_t key, int score) {
+    uint64_t word = (static_cast<uint64_t>(keyCheck(key)) << 32) | static_cast<uint32_t>(score);
+    entryFor(key).store(word, std::memory_order_relaxed);
+}
+
+EvalCache::Stats EvalCache::getStats() const {
+    Stats stats;
+    stats.probes = m_probes.load(std::memory_order_relaxed);
+    stats.hits = m_hits.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void EvalCache::resetStats() {
+    m_probes.store(0, std::memory_order_relaxed);
+    m_hits.store(0, std::memory_order_relaxed);
+}
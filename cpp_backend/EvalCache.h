@@ -0,0 +1,51 @@
+#ifndef ABALONE_EVAL_CACHE_H
+#define ABALONE_EVAL_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Lock-free cache of static evaluations shared by every search thread.
+//
+// Direct mapped: the low key bits pick the entry, which is one 64-bit word read
+// and written atomically, so a reader sees a whole entry or none of it.
+//   bits 0-31  score (int32)
+//   bits 32-63 key check (key >> 32, low bit forced to 1 so an empty word never matches)
+// The key is the position's Zobrist hash.
+class EvalCache {
+public:
+    struct Stats {
+        long long probes = 0;
+        long long hits = 0;
+
+        double hitRate() const { return probes > 0 ? 100.0 * hits / probes : 0.0; }
+    };
+
+    // Size in KB, rounded down to a power-of-two number of entries.
+    EvalCache(size_t sizeInKB = 512);
+
+    // Empties the cache and resets its statistics.
+    void clear();
+
+    bool probe(uint64_t key, int& score);
+    void store(uint64_t key, int score);
+
+    Stats getStats() const;
+    void resetStats();
+
+    size_t getEntryCount() const { return m_entryCount; }
+
+private:
+    static uint32_t keyCheck(uint64_t key) { return static_cast<uint32_t>(key >> 32) | 1; }
+
+    std::atomic<uint64_t>& entryFor(uint64_t key) { return m_entries[key & (m_entryCount - 1)]; }
+
+    std::unique_ptr<std::atomic<uint64_t>[]> m_entries;
+    size_t m_entryCount;
+
+    std::atomic<long long> m_probes{ 0 };
+    std::atomic<long long> m_hits{ 0 };
+};
+
+#endif // ABALONE_EVAL_CACHE_H
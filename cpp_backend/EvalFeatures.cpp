@@ -0,0 +1,175 @@
+#include "EvalFeatures.h"
+#include "Board.h"
+
+// The AVX2 kernel is compiled in when the build targets AVX2, or, with GCC and
+// Clang on x86, as a target("avx2") function that is only called once the CPU
+// has been checked to support it (so the plain -O2 Python module gets it too).
+#if defined(__AVX2__)
+#define EVAL_HAVE_AVX2 1
+#define EVAL_AVX2_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define EVAL_HAVE_AVX2 1
+#define EVAL_AVX2_RUNTIME_CHECK 1
+#define EVAL_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+#if defined(EVAL_HAVE_AVX2)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using BoardGeometry::LINE_AXES;
+using BoardGeometry::OPPOSITE_DIRECTION;
+
+// Cells with an on-board neighbour on both sides along an axis: the middle
+// cells of that axis' lines of three.
+constexpr std::array<uint64_t, 3> makeLineMiddles() {
+    std::array<uint64_t, 3> middles{};
+    for (int a = 0; a < 3; ++a) {
+        int d = LINE_AXES[a];
+        for (int cell = 0; cell < BoardGeometry::NUM_CELLS; ++cell) {
+            if (BoardGeometry::NEIGHBORS[cell][d] >= 0 &&
+                BoardGeometry::NEIGHBORS[cell][OPPOSITE_DIRECTION[d]] >= 0) {
+                middles[a] |= 1ULL << cell;
+            }
+        }
+    }
+    return middles;
+}
+
+constexpr std::array<uint64_t, 3> LINE_MIDDLES = makeLineMiddles();
+
+//========================== Scalar Kernel ==========================//
+
+void scalarFeatures(const std::array<uint64_t, 2>& position, EvalFeatures& features) {
+    uint64_t empty = BoardGeometry::BOARD_MASK & ~(position[0] | position[1]);
+    for (int s = 0; s < 2; s++) {
+        uint64_t own = position[s];
+        int pairs = 0;
+        int threats = 0;
+        for (int a = 0; a < 3; a++) {
+            int d = LINE_AXES[a];
+            // Moved one step along the axis: the own bit of the cell behind / ahead of each cell.
+            uint64_t behind = Board::shiftBitboard(own, d);
+            uint64_t ahead = Board::shiftBitboard(own, OPPOSITE_DIRECTION[d]);
+            pairs += Board::popcount(own & behind);
+            threats += Board::popcount(empty & LINE_MIDDLES[a] & (behind ^ ahead));
+        }
+        features.marbles[s] = Board::popcount(own);
+        features.center[s] = Board::popcount(own & CENTER_MASK);
+        features.cohesion[s] = 2 * pairs;
+        features.edge[s] = Board::popcount(own & BoardGeometry::EDGE_MASK);
+        features.threats[s] = threats;
+    }
+}
+
+//========================== AVX2 Kernel ==========================//
+
+#if defined(EVAL_HAVE_AVX2)
+
+// Per-lane (64-bit) population count: nibble lookup, then a byte sum per lane.
+EVAL_AVX2_TARGET inline __m256i popcount4(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibbles = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_and_si256(v, lowNibbles);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibbles);
+    __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+    return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+}
+
+// Board::shiftBitboard on four bitboards at once.
+EVAL_AVX2_TARGET inline __m256i shift4(__m256i bits, int direction) {
+    __m256i result = _mm256_setzero_si256();
+    for (const BoardGeometry::RowShift& row : BoardGeometry::ROW_SHIFTS[direction]) {
+        __m256i src = _mm256_and_si256(bits, _mm256_set1_epi64x(static_cast<long long>(row.mask)));
+        __m256i moved = (row.shift >= 0) ? _mm256_sll_epi64(src, _mm_cvtsi32_si128(row.shift))
+                                         : _mm256_srl_epi64(src, _mm_cvtsi32_si128(-row.shift));
+        result = _mm256_or_si256(result, moved);
+    }
+    return result;
+}
+
+EVAL_AVX2_TARGET inline __m256i and4(uint64_t mask, __m256i v) {
+    return _mm256_and_si256(_mm256_set1_epi64x(static_cast<long long>(mask)), v);
+}
+
+EVAL_AVX2_TARGET void avx2Features(const std::array<uint64_t, 2>* positions, EvalFeatures* features) {
+    __m256i sides[2];
+    for (int s = 0; s < 2; s++) {
+        sides[s] = _mm256_setr_epi64x(static_cast<long long>(positions[0][s]), static_cast<long long>(positions[1][s]),
+                                      static_cast<long long>(positions[2][s]), static_cast<long long>(positions[3][s]));
+    }
+    __m256i empty = _mm256_andnot_si256(_mm256_or_si256(sides[0], sides[1]),
+                                        _mm256_set1_epi64x(static_cast<long long>(BoardGeometry::BOARD_MASK)));
+
+    for (int s = 0; s < 2; s++) {
+        __m256i own = sides[s];
+        __m256i pairs = _mm256_setzero_si256();
+        __m256i threats = _mm256_setzero_si256();
+        for (int a = 0; a < 3; a++) {
+            int d = LINE_AXES[a];
+            __m256i behind = shift4(own, d);
+            __m256i ahead = shift4(own, OPPOSITE_DIRECTION[d]);
+            pairs = _mm256_add_epi64(pairs, popcount4(_mm256_and_si256(own, behind)));
+            threats = _mm256_add_epi64(threats, popcount4(
+                and4(LINE_MIDDLES[a], _mm256_and_si256(empty, _mm256_xor_si256(behind, ahead)))));
+        }
+
+        alignas(32) uint64_t marbles[4], center[4], cohesion[4], edge[4], threatCounts[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(marbles), popcount4(own));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(center), popcount4(and4(CENTER_MASK, own)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(cohesion), _mm256_add_epi64(pairs, pairs));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(edge), popcount4(and4(BoardGeometry::EDGE_MASK, own)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(threatCounts), threats);
+        for (int lane = 0; lane < 4; lane++) {
+            features[lane].marbles[s] = static_cast<int>(marbles[lane]);
+            features[lane].center[s] = static_cast<int>(center[lane]);
+            features[lane].cohesion[s] = static_cast<int>(cohesion[lane]);
+            features[lane].edge[s] = static_cast<int>(edge[lane]);
+            features[lane].threats[s] = static_cast<int>(threatCounts[lane]);
+        }
+    }
+}
+
+#endif
+
+bool avx2Supported() {
+#if defined(EVAL_AVX2_RUNTIME_CHECK)
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#elif defined(EVAL_HAVE_AVX2)
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+namespace EvalBatch {
+
+bool vectorized() {
+    return avx2Supported();
+}
+
+void computeFeaturesScalar(const std::array<uint64_t, 2>* positions, int count, EvalFeatures* features) {
+    for (int i = 0; i < count; i++) {
+        scalarFeatures(positions[i], features[i]);
+    }
+}
+
+void computeFeatures(const std::array<uint64_t, 2>* positions, int count, EvalFeatures* features) {
+    int done = 0;
+#if defined(EVAL_HAVE_AVX2)
+    if (avx2Supported()) {
+        for (; done + 4 <= count; done += 4) {
+            avx2Features(positions + done, features + done);
+        }
+    }
+#endif
+    computeFeaturesScalar(positions + done, count - done, features + done);
+}
+
+} // namespace EvalBatch
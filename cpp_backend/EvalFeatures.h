@@ -0,0 +1,53 @@
+#ifndef ABALONE_EVAL_FEATURES_H
+#define ABALONE_EVAL_FEATURES_H
+
+#include <array>
+#include <cstdint>
+
+#include "BoardGeometry.h"
+
+//------------------------------------------------------------------------------
+// Evaluation Features
+//------------------------------------------------------------------------------
+
+// The terms of AbaloneAI::evaluatePosition per side ([0] black, [1] white).
+// The search keeps them up to date move by move, so a leaf is just their
+// weighted sum; EvalBatch computes them from scratch for many positions.
+struct EvalFeatures {
+    std::array<int, 2> marbles{};
+    std::array<int, 2> center{};     // marbles on the five centre cells
+    std::array<int, 2> cohesion{};   // ordered pairs of adjacent own marbles
+    std::array<int, 2> edge{};       // marbles on edge cells
+    std::array<int, 2> threats{};    // own marble, empty cell, then a cell that is not ours
+};
+
+// The five centre cells E5, D5, F5, E4 and E6 (notation is row letter, then diagonal number).
+inline constexpr uint64_t CENTER_MASK =
+    (1ULL << BoardGeometry::coordToIndex(5, 5)) | (1ULL << BoardGeometry::coordToIndex(5, 4)) |
+    (1ULL << BoardGeometry::coordToIndex(5, 6)) | (1ULL << BoardGeometry::coordToIndex(4, 5)) |
+    (1ULL << BoardGeometry::coordToIndex(6, 5));
+
+// Feature extraction for a batch of positions, each given as its {black, white}
+// bitboards. Features are counted per line axis (E, NW, NE) with row shifts:
+// cohesion from neighbouring pairs, threats from lines of three whose middle
+// cell is empty and whose ends differ in ownership.
+//
+// computeFeatures runs an AVX2 kernel over four positions at a time when the CPU
+// supports it, and the scalar kernel otherwise. With GCC and Clang on x86 the
+// choice is made at run time, so builds without -mavx2 / -march=native (such as
+// the Python module) still use AVX2; other compilers need the build to target
+// AVX2 (e.g. MSVC /arch:AVX2). Both give exactly the counts of
+// AbaloneAI::computeFeatures.
+namespace EvalBatch {
+
+// True if computeFeatures uses the AVX2 kernel on this machine.
+bool vectorized();
+
+void computeFeatures(const std::array<uint64_t, 2>* positions, int count, EvalFeatures* features);
+
+// The scalar kernel, always available (used for the remainder of a batch and for benchmarking).
+void computeFeaturesScalar(const std::array<uint64_t, 2>* positions, int count, EvalFeatures* features);
+
+} // namespace EvalBatch
+
+#endif // ABALONE_EVAL_FEATURES_H
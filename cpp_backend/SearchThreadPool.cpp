@@ -0,0 +1,61 @@
+#include "SearchThreadPool.h"
+
+SearchThreadPool::SearchThreadPool(int workerCount) {
+    for (int id = 1; id <= workerCount; ++id) {
+        m_threads.emplace_back(&SearchThreadPool::workerLoop, this, id);
+    }
+}
+
+SearchThreadPool::~SearchThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_wakeWorkers.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void SearchThreadPool::start(std::function<void(int)> job) {
+    if (m_threads.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = std::move(job);
+        m_running = size();
+        m_generation++;
+    }
+    m_wakeWorkers.notify_all();
+}
+
+void SearchThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobDone.wait(lock, [this]() { return m_running == 0; });
+}
+
+void SearchThreadPool::workerLoop(int id) {
+    uint64_t seenGeneration = 0;
+    while (true) {
+        std::function<void(int)>* job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeWorkers.wait(lock, [&]() { return m_shutdown || m_generation != seenGeneration; });
+            if (m_shutdown) {
+                return;
+            }
+            seenGeneration = m_generation;
+            job = &m_job;
+        }
+
+        // m_job is only replaced by start(), which waits for this job to finish first.
+        (*job)(id);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running--;
+        }
+        m_jobDone.notify_all();
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef SEARCH_THREAD_POOL_H
+#define SEARCH_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of helper threads owned by an AbaloneAI for its whole lifetime.
+// Workers sleep on a condition variable between searches; start() hands every
+// worker the same job and wait() blocks until all of them have returned from it.
+class SearchThreadPool {
+public:
+    // Starts 'workerCount' parked threads (0 is allowed and makes start/wait no-ops).
+    explicit SearchThreadPool(int workerCount);
+
+    // Wakes the workers one last time so they can exit, then joins them.
+    ~SearchThreadPool();
+
+    SearchThreadPool(const SearchThreadPool&) = delete;
+    SearchThreadPool& operator=(const SearchThreadPool&) = delete;
+
+    // Runs job(id) on every worker, with ids 1..size(). Returns immediately.
+    // Must not be called again before wait() has returned.
+    void start(std::function<void(int)> job);
+
+    // Blocks until every worker has finished the job given to the last start().
+    void wait();
+
+    int size() const { return static_cast<int>(m_threads.size()); }
+
+private:
+    void workerLoop(int id);
+
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeWorkers;
+    std::condition_variable m_jobDone;
+
+    std::function<void(int)> m_job;
+    uint64_t m_generation = 0;  // bumped by every start(); workers run each generation once
+    int m_running = 0;          // workers still inside the current job
+    bool m_shutdown = false;
+};
+
+#endif // SEARCH_THREAD_POOL_H
@@ -0,0 +1,35 @@
+#include "TimeManager.h"
+#include <algorithm>
+
+int64_t TimeManager::moveBudgetMs(const TimeControl& control) {
+    int64_t budget = -1;
+    if (control.moveTimeMs > 0) {
+        budget = control.moveTimeMs;
+    }
+    if (control.remainingMs > 0) {
+        // An even share of the clock plus most of the increment, but never more
+        // than half of what is left.
+        int movesToGo = control.movesToGo > 0 ? control.movesToGo : DEFAULT_MOVES_TO_GO;
+        int64_t share = control.remainingMs / movesToGo + static_cast<int64_t>(control.incrementMs) * 3 / 4;
+        share = std::min<int64_t>(share, control.remainingMs / 2);
+        budget = (budget < 0) ? share : std::min(budget, share);
+    }
+    return budget;
+}
+
+void TimeManager::start(const TimeControl& control) {
+    m_start = std::chrono::steady_clock::now();
+
+    int64_t budget = moveBudgetMs(control);
+    if (budget < 0) {
+        m_softLimitMs = -1;
+        m_hardLimitMs = -1;
+        return;
+    }
+    m_hardLimitMs = std::max<int64_t>(1, budget - SAFETY_MARGIN_MS);
+    m_softLimitMs = budget * SOFT_LIMIT_PERCENT / 100;
+}
+
+int64_t TimeManager::elapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_start).count();
+}
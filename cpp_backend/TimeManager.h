@@ -0,0 +1,57 @@
+#ifndef TIME_MANAGER_H
+#define TIME_MANAGER_H
+
+#include <chrono>
+#include <cstdint>
+
+// How much time one move may take. The GUI gives a fixed time per move;
+// a game clock (time left, increment, moves to go) can be budgeted instead or
+// as well, in which case the tighter of the two applies. 0 means "not set".
+struct TimeControl {
+    int moveTimeMs = 0;     // fixed budget per move
+    int remainingMs = 0;    // time left on our clock
+    int incrementMs = 0;    // added to our clock after every move
+    int movesToGo = 0;      // moves until the clock is next refilled (0: unknown)
+};
+
+// The clock of one move's search.
+//
+// start() turns a TimeControl into two limits: past the soft limit no new
+// iteration is started (it would hardly ever finish), at the hard limit the
+// search in progress is abandoned. The hard limit sits a few milliseconds before
+// the budget so that unwinding the search still returns in time. start() is
+// called between searches; while one runs, every search thread polls
+// hardLimitReached().
+class TimeManager {
+public:
+    // Moves assumed to remain when a game clock gives no moves-to-go.
+    static const int DEFAULT_MOVES_TO_GO = 30;
+    // Kept back from the budget for unwinding the search and returning the move.
+    static const int SAFETY_MARGIN_MS = 3;
+    // Share of the budget after which no new iteration starts.
+    static const int SOFT_LIMIT_PERCENT = 50;
+
+    // Starts the clock with limits derived from 'control'.
+    void start(const TimeControl& control);
+
+    // Milliseconds since start().
+    int64_t elapsedMs() const;
+
+    bool softLimitReached() const { return hasLimit() && elapsedMs() >= m_softLimitMs; }
+    bool hardLimitReached() const { return hasLimit() && elapsedMs() >= m_hardLimitMs; }
+
+    // The limits of the current move (meaningless when there is no limit).
+    bool hasLimit() const { return m_hardLimitMs >= 0; }
+    int64_t softLimitMs() const { return m_softLimitMs; }
+    int64_t hardLimitMs() const { return m_hardLimitMs; }
+
+    // Time the move is allowed to take according to 'control', or -1 for no limit.
+    static int64_t moveBudgetMs(const TimeControl& control);
+
+private:
+    std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+    int64_t m_softLimitMs = -1;
+    int64_t m_hardLimitMs = -1;
+};
+
+#endif // TIME_MANAGER_H
@@ -1,60 +1,29 @@
 #include "TranspositionTable.h"
-#include <random>
-#include <chrono>
-#include <iostream>
-#include <cstring>
-#include <cstring>
-
-// Zobrist key initialization
-bool TranspositionTable::s_zobristInitialized = false;
-std::array<std::array<uint64_t, 3>, Board::NUM_CELLS> TranspositionTable::s_zobristKeys;
+#include <algorithm>
+#include <climits>
 
 TranspositionTable::TranspositionTable(size_t sizeInMB) {
-    initZobristKeys();
-    size_t entryCount = (sizeInMB * 1024 * 1024) / sizeof(TTEntry);
-    m_table.resize(entryCount);
+    // Round down to a power of two so the bucket index is a mask of the hash.
+    size_t bucketCount = std::max<size_t>(1, (sizeInMB * 1024 * 1024) / sizeof(Bucket));
+    m_bucketCount = 1;
+    while (m_bucketCount * 2 <= bucketCount) {
+        m_bucketCount *= 2;
+    }
+    m_buckets.reset(new Bucket[m_bucketCount]);
     m_currentAge = 0;
-    m_hits = 0;
-    m_probes = 0;
     clearTable();
 }
 
 void TranspositionTable::incrementAge() {
-    m_currentAge++;
-}
-
-double TranspositionTable::getHitRate() {
-    return (m_probes > 0) ? ((double)m_hits / m_probes * 100.0) : 0.0;
-}
-
-void TranspositionTable::initZobristKeys() {
-    // Initialize only once
-    if (s_zobristInitialized) return;
-
-
-    // Initialize with random values using a good random number generator
-    std::mt19937_64 rng(std::chrono::steady_clock::now().time_since_epoch().count());
-    std::uniform_int_distribution<uint64_t> dist;
-
-
-    for (int i = 0; i < Board::NUM_CELLS; ++i) {
-        for (int j = 0; j < 3; ++j) { // 3 = EMPTY, BLACK, WHITE
-            s_zobristKeys[i][j] = dist(rng);
-        }
-    }
-
-
-    // Additional key for the side to move
-    m_sideToMoveKey = dist(rng);
-
-
-    s_zobristInitialized = true;
+    m_currentAge.store((m_currentAge.load(std::memory_order_relaxed) + 1) & AGE_MASK, std::memory_order_relaxed);
 }
 
 // Clear the table
 void TranspositionTable::clearTable() {
-    for (auto& entry : m_table) {
-        entry = TTEntry();
+    for (size_t b = 0; b < m_bucketCount; ++b) {
+        for (auto& entry : m_buckets[b].entries) {
+            entry.store(0, std::memory_order_relaxed);
+        }
     }
 }
 
@@ -65,110 +34,149 @@ uint64_t TranspositionTable::computeHash(const Board& board) {
 
     // Hash the occupants
     for (int i = 0; i < Board::NUM_CELLS; ++i) {
-        Occupant occ = board.getOccupant(i);
-        if (occ != Occupant::EMPTY) {
-            int occIndex = (occ == Occupant::BLACK) ? 1 : 2;
-            hash ^= s_zobristKeys[i][occIndex];
-        }
+        hash ^= Zobrist::CELL_KEYS[i][static_cast<int>(board.getOccupant(i))];
     }
 
 
     // Hash the side to move
     if (board.nextToMove == Occupant::WHITE) {
-        hash ^= m_sideToMoveKey;
+        hash ^= Zobrist::SIDE_TO_MOVE_KEY;
     }
 
 
     return hash;
 }
 
+//========================== Entry Packing ==========================//
+
+// Scores saturate to +/-32767 in the 16-bit field; the saturated values read
+// back as the int extremes minimax uses for positions without moves.
+static const int SCORE_LIMIT = 32767;
+
+uint64_t TranspositionTable::pack(uint64_t hash, const Move& move, int score, int depth, MoveType type, int age) {
+    int clampedScore = std::max(-SCORE_LIMIT, std::min(SCORE_LIMIT, score));
+    int clampedDepth = std::max(0, std::min(255, depth));
+    return (hash >> 48)
+        | (static_cast<uint64_t>(move.code & 0xFFFF) << 16)
+        | (static_cast<uint64_t>(static_cast<uint16_t>(static_cast<int16_t>(clampedScore))) << 32)
+        | (static_cast<uint64_t>(clampedDepth) << 48)
+        | (static_cast<uint64_t>(static_cast<int>(type) + 1) << 56)
+        | (static_cast<uint64_t>(age & AGE_MASK) << 58);
+}
+
+Move TranspositionTable::moveOf(uint64_t word) {
+    Move move;
+    move.code = static_cast<uint32_t>((word >> 16) & 0xFFFF);
+    return move;
+}
+
+int TranspositionTable::scoreOf(uint64_t word) {
+    int score = static_cast<int16_t>(static_cast<uint16_t>(word >> 32));
+    if (score >= SCORE_LIMIT) return INT_MAX;
+    if (score <= -SCORE_LIMIT) return INT_MIN;
+    return score;
+}
+
+//========================== Store and Probe ==========================//
+
 // Store a position in the transposition table
-void TranspositionTable::storeEntry(const Board& board, int depth, int score, MoveType moveType, const Move& bestMove) {
-    uint64_t hash = computeHash(board);
-    size_t index = hash % m_table.size();
-
-    TTEntry& entry = m_table[index];
-
-    // Always replace with the following exceptions:
-    // 1. If it's the same position but we have a deeper search stored
-    // 2. If the existing entry is from the current search and has higher depth
-    bool shouldReplace = true;
-
-    if (entry.isOccupied && entry.key == hash) {
-        // Same position
-        if (entry.age == m_currentAge) {
-            // Same search - prefer deeper searches or exact nodes
-            if (entry.depth > depth && entry.type == MoveType::EXACT) {
-                shouldReplace = false;
-            }
-            else if (entry.depth == depth) {
-                // Equal depth, prefer more accurate node types
-                if (entry.type == MoveType::EXACT && moveType != MoveType::EXACT) {
+void TranspositionTable::storeEntry(uint64_t hash, int depth, int score, MoveType moveType, const Move& bestMove) {
+    Bucket& bucket = bucketFor(hash);
+    uint16_t check = static_cast<uint16_t>(hash >> 48);
+    int age = m_currentAge.load(std::memory_order_relaxed);
+
+    std::atomic<uint64_t>* victim = &bucket.entries[0];
+    int victimWorth = INT_MAX;
+
+    for (auto& slot : bucket.entries) {
+        uint64_t word = slot.load(std::memory_order_relaxed);
+
+        if (boundOf(word) != 0 && keyCheck(word) == check) {
+            // Same position: keep what is stored when it is worth more.
+            int entryDepth = depthOf(word);
+            int entryAge = ageOf(word);
+            MoveType entryType = static_cast<MoveType>(boundOf(word) - 1);
+            bool shouldReplace = true;
+
+            if (entryAge == age) {
+                // Same search - prefer deeper searches or exact nodes
+                if (entryDepth > depth && entryType == MoveType::EXACT) {
+                    shouldReplace = false;
+                }
+                else if (entryDepth == depth && entryType == MoveType::EXACT && moveType != MoveType::EXACT) {
+                    // Equal depth, prefer more accurate node types
                     shouldReplace = false;
                 }
             }
+
+            // For entries that are almost done with their search, always keep them
+            if (entryDepth >= depth + 3 && entryAge == ((age - 1) & AGE_MASK)) {
+                shouldReplace = false;
+            }
+
+            if (shouldReplace) {
+                Move move = bestMove.isNull() ? moveOf(word) : bestMove;
+                slot.store(pack(hash, move, score, depth, moveType, age), std::memory_order_relaxed);
+            }
+            else if (moveOf(word).isNull() && !bestMove.isNull()) {
+                // Always update the best move if we didn't have one
+                slot.store(pack(hash, bestMove, scoreOf(word), entryDepth, entryType, entryAge),
+                           std::memory_order_relaxed);
+            }
+            return;
         }
-    }
 
-    // For entries that are almost done with their search, always keep them
-    if (entry.isOccupied && entry.key == hash &&
-        entry.depth >= depth + 3 && entry.age == m_currentAge - 1) {
-        shouldReplace = false;
+        // Otherwise evict the empty, oldest or shallowest entry in the bucket.
+        int worth = (boundOf(word) == 0)
+            ? INT_MIN
+            : depthOf(word) - 8 * ((age - ageOf(word)) & AGE_MASK);
+        if (worth < victimWorth) {
+            victimWorth = worth;
+            victim = &slot;
+        }
     }
 
-    if (shouldReplace) {
-        entry.key = hash;
-        entry.depth = depth;
-        entry.score = score;
-        entry.type = moveType;
-        entry.bestMove = bestMove;
-        entry.isOccupied = true;
-        entry.age = m_currentAge;
-    }
-    else if (entry.key == hash && entry.bestMove.marbleIndices.empty() && !bestMove.marbleIndices.empty()) {
-        // Always update the best move if we didn't have one
-        entry.bestMove = bestMove;
-    }
+    victim->store(pack(hash, bestMove, score, depth, moveType, age), std::memory_order_relaxed);
 }
 
 // Probe the transposition table for a position
-bool TranspositionTable::probeEntry(const Board& board, int depth, int& score, MoveType& moveType, Move& bestMove) {
-    uint64_t hash = computeHash(board);
-    size_t index = hash % m_table.size();
-
-    m_probes++;  // Increment probe counter
-
-    TTEntry& entry = m_table[index];
+bool TranspositionTable::probeEntry(uint64_t hash, int depth, int& score, MoveType& moveType, Move& bestMove) {
+    Bucket& bucket = bucketFor(hash);
+    uint16_t check = static_cast<uint16_t>(hash >> 48);
+
+    for (auto& slot : bucket.entries) {
+        uint64_t word = slot.load(std::memory_order_relaxed);
+        if (boundOf(word) == 0 || keyCheck(word) != check) {
+            continue;
+        }
 
-    // Checks if the entry is valid and matches our position
-    if (entry.isOccupied && entry.key == hash) {
         // We found a matching position
-        if (entry.depth >= depth) {
-            m_hits++;  // Increment hit counter
-            score = entry.score;
-            moveType = entry.type;
-            bestMove = entry.bestMove;
+        if (depthOf(word) >= depth) {
+            score = scoreOf(word);
+            moveType = static_cast<MoveType>(boundOf(word) - 1);
+            bestMove = moveOf(word);
             return true;
         }
 
         // Entry is too shallow but we can still use the move
-        bestMove = entry.bestMove;
+        bestMove = moveOf(word);
+        return false;
     }
 
     return false;
 }
 
 // Get the best move from transposition table without depth/score requirements
-bool TranspositionTable::getBestMove(const Board& board, Move& bestMove) {
-    uint64_t hash = computeHash(board);
-    size_t index = hash % m_table.size();
-
-    TTEntry& entry = m_table[index];
-
-    // Checks if the entry is occupied AND if its Zobrist key matches the current position's hash
-    if (entry.isOccupied && entry.key == hash) {
-        bestMove = entry.bestMove;
-        return true;
+bool TranspositionTable::getBestMove(uint64_t hash, Move& bestMove) {
+    Bucket& bucket = bucketFor(hash);
+    uint16_t check = static_cast<uint16_t>(hash >> 48);
+
+    for (auto& slot : bucket.entries) {
+        uint64_t word = slot.load(std::memory_order_relaxed);
+        if (boundOf(word) != 0 && keyCheck(word) == check) {
+            bestMove = moveOf(word);
+            return true;
+        }
     }
 
     return false;
@@ -176,13 +184,17 @@ bool TranspositionTable::getBestMove(const Board& board, Move& bestMove) {
 
 // Get the current usage percentage of the table
 double TranspositionTable::getUsage() {
+    // A full scan of a large table takes milliseconds; the first buckets are a fair sample.
+    size_t sampleBuckets = std::min<size_t>(m_bucketCount, 1024);
     size_t usedEntries = 0;
 
-    for (const auto& entry : m_table) {
-        if (entry.isOccupied) {
-            usedEntries++;
+    for (size_t b = 0; b < sampleBuckets; ++b) {
+        for (const auto& entry : m_buckets[b].entries) {
+            if (boundOf(entry.load(std::memory_order_relaxed)) != 0) {
+                usedEntries++;
+            }
         }
     }
 
-    return (double)usedEntries / m_table.size() * 100.0;
+    return (double)usedEntries / (sampleBuckets * BUCKET_SIZE) * 100.0;
 }
\ No newline at end of file
@@ -2,8 +2,10 @@
 #define TRANSPOSITION_TABLE_H
 
 #include "Board.h"
-#include <vector>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 
 // Define MoveType enum outside of the class
 enum class MoveType {
@@ -12,69 +14,75 @@ enum class MoveType {
     UPPERBOUND  // Beta cutoff (score <= beta)
 };
 
-// Define TTEntry completely before using it in std::vector
-struct TTEntry {
-    uint64_t key;       // Zobrist hash key
-    int depth;          // Search depth
-    int score;          // Evaluation score
-    MoveType type;      // Type of node (exact, lower bound, upper bound)
-    Move bestMove;      // Best move from this position
-    bool isOccupied;         // Entry validity flag. An invalid entry is considered empty.
-    int age;            // Age of the entry (used for replacement strategy)
-    
-    // Constructor
-    TTEntry() : key(0), depth(0), score(0), type(MoveType::EXACT), isOccupied(false), age(0) {}
-};
-
+// Lock-free transposition table shared by every search thread.
+//
+// Each entry is one 64-bit word, read and written atomically, so a reader sees
+// either the old or the new entry and never a mix of two. Eight entries share a
+// 64-byte, cache-line-aligned bucket; the low hash bits pick the bucket and the
+// top 16 bits are stored to tell positions in the same bucket apart.
+//   bits 0-15  key check (hash >> 48)
+//   bits 16-31 best move (Move::code fits in 16 bits)
+//   bits 32-47 score (int16, saturated)
+//   bits 48-55 depth
+//   bits 56-57 bound (MoveType + 1; 0 = empty)
+//   bits 58-63 age of the search that wrote it
 class TranspositionTable {
 public:
+    static const int BUCKET_SIZE = 8;
+
     // Constructor - size in MB
     TranspositionTable(size_t sizeInMB = 64);
-    
+
     // Clear the table
     void clearTable();
-    
-    // Store a position in the transposition table
-    void storeEntry(const Board& board, int depth, int score, MoveType moveType, const Move& bestMove);
-    
+
+    // Store a position in the transposition table.
+    // 'hash' is the position's Zobrist hash (Board::hash()).
+    void storeEntry(uint64_t hash, int depth, int score, MoveType moveType, const Move& bestMove);
+
     // Probe the transposition table for a position
-    bool probeEntry(const Board& board, int depth, int& score, MoveType& moveType, Move& bestMove);
-    
+    bool probeEntry(uint64_t hash, int depth, int& score, MoveType& moveType, Move& bestMove);
+
     // Get the best move from transposition table without depth/score requirements
-    bool getBestMove(const Board& board, Move& bestMove);
-    
-    // Get the current usage percentage of the table
+    bool getBestMove(uint64_t hash, Move& bestMove);
+
+    // Get the current usage percentage of the table (sampled from the first buckets)
     double getUsage();
-    
-    // Compute Zobrist hash for a given board position
-    uint64_t computeHash(const Board& board);
 
-    void incrementAge();
+    // Computes the Zobrist hash of a position from scratch. Matches Board::hash(),
+    // which is maintained incrementally and is what the search uses.
+    static uint64_t computeHash(const Board& board);
 
+    void incrementAge();
 
-    double getHitRate();
+    // Number of entries the table holds.
+    size_t getEntryCount() const { return m_bucketCount * BUCKET_SIZE; }
 
 private:
-    // Initialize Zobrist keys
-    void initZobristKeys();
-    
-    // Zobrist keys for each cell and piece type
-    static bool s_zobristInitialized;
-    static std::array<std::array<uint64_t, 3>, Board::NUM_CELLS> s_zobristKeys; // [cell][piece]
-    
-    // Additional key for the side to move
-    uint64_t m_sideToMoveKey;
-    
-    // The actual transposition table
-    std::vector<TTEntry> m_table;
-
-    // Age of the entries
-    int m_currentAge;
-
-    // Counters for hit rate tracking
-    size_t m_hits;
-    size_t m_probes;
+    struct alignas(64) Bucket {
+        std::atomic<uint64_t> entries[BUCKET_SIZE];
+    };
+    static_assert(sizeof(Bucket) == 64, "A bucket must fill exactly one cache line");
+
+    static const int AGE_MASK = 0x3F;
+
+    // Entry packing helpers.
+    static uint64_t pack(uint64_t hash, const Move& move, int score, int depth, MoveType type, int age);
+    static uint16_t keyCheck(uint64_t word) { return static_cast<uint16_t>(word); }
+    static Move moveOf(uint64_t word);
+    static int scoreOf(uint64_t word);
+    static int depthOf(uint64_t word) { return static_cast<int>((word >> 48) & 0xFF); }
+    static int boundOf(uint64_t word) { return static_cast<int>((word >> 56) & 0x3); }
+    static int ageOf(uint64_t word) { return static_cast<int>(word >> 58); }
+
+    Bucket& bucketFor(uint64_t hash) { return m_buckets[hash & (m_bucketCount - 1)]; }
+
+    // The actual table: a power-of-two number of buckets.
+    std::unique_ptr<Bucket[]> m_buckets;
+    size_t m_bucketCount;
 
+    // Age of the current search (6 bits, wraps around)
+    std::atomic<int> m_currentAge;
 };
 
 #endif // TRANSPOSITION_TABLE_H
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef ABALONE_ZOBRIST_H
+#define ABALONE_ZOBRIST_H
+
+#include <array>
+#include <cstdint>
+
+#include "BoardGeometry.h"
+
+//------------------------------------------------------------------------------
+// Zobrist Keys
+//------------------------------------------------------------------------------
+//
+// Keys are generated at compile time from a fixed seed, so a position hashes to
+// the same value in every run and every process.
+
+namespace Zobrist {
+
+constexpr uint64_t SEED = 0x9E3779B97F4A7C15ULL;
+
+// SplitMix64 step: advances 'state' and returns the next key.
+constexpr uint64_t nextKey(uint64_t& state) {
+    state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+namespace detail {
+
+// [cell][occupant]; the EMPTY column is zero so empty cells do not contribute.
+constexpr std::array<std::array<uint64_t, 3>, BoardGeometry::NUM_CELLS> makeCellKeys() {
+    std::array<std::array<uint64_t, 3>, BoardGeometry::NUM_CELLS> keys{};
+    uint64_t state = SEED;
+    for (int i = 0; i < BoardGeometry::NUM_CELLS; ++i) {
+        keys[i][0] = 0;
+        keys[i][1] = nextKey(state);
+        keys[i][2] = nextKey(state);
+    }
+    return keys;
+}
+
+constexpr uint64_t makeSideKey() {
+    uint64_t state = SEED ^ 0xD1B54A32D192ED03ULL;
+    return nextKey(state);
+}
+
+} // namespace detail
+
+// CELL_KEYS[i][occupant] with occupant 0 = EMPTY, 1 = BLACK, 2 = WHITE.
+inline constexpr std::array<std::array<uint64_t, 3>, BoardGeometry::NUM_CELLS> CELL_KEYS = detail::makeCellKeys();
+
+// XORed in when white is to move.
+inline constexpr uint64_t SIDE_TO_MOVE_KEY = detail::makeSideKey();
+
+} // namespace Zobrist
+
+#endif // ABALONE_ZOBRIST_H
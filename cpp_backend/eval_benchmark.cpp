@@ -0,0 +1,112 @@
+// eval_benchmark.cpp
+#include "Board.h"
+#include "EvalFeatures.h"
+#include "AbaloneAI.h"
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <chrono>
+#include <string>
+#include <algorithm>
+
+// Positions from random games (pushes preferred, so marbles actually leave the board).
+std::vector<std::array<uint64_t, 2>> samplePositions(int games) {
+    std::vector<std::array<uint64_t, 2>> positions;
+    for (int g = 0; g < games; g++) {
+        Board board;
+        if (g % 3 == 0) {
+            board.initStandardLayout();
+        } else if (g % 3 == 1) {
+            board.initBelgianDaisyLayout();
+        } else {
+            board.initGermanDaisyLayout();
+        }
+        for (int ply = 0; ply < 100; ply++) {
+            MoveList moves = board.generateMoves(board.nextToMove);
+            if (moves.empty() || board.countMarbles(Occupant::BLACK) < 9 || board.countMarbles(Occupant::WHITE) < 9) {
+                break;
+            }
+            positions.push_back(board.bitboards);
+            Move move = moves[std::rand() % moves.size()];
+            for (int i = 0; i < moves.size(); i++) {
+                if (moves[i].pushCount() > 0 && std::rand() % 2) {
+                    move = moves[i];
+                    break;
+                }
+            }
+            board.makeMove(move);
+        }
+    }
+    return positions;
+}
+
+// Evaluations per second of 'kernel' over 'positions', best of a few runs.
+template <typename Kernel>
+double evalsPerSecond(Kernel kernel, const std::vector<std::array<uint64_t, 2>>& positions,
+                      std::vector<EvalFeatures>& features, int rounds) {
+    double best = 0.0;
+    for (int run = 0; run < 5; run++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            kernel(positions.data(), static_cast<int>(positions.size()), features.data());
+        }
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+        best = std::max(best, positions.size() * static_cast<double>(rounds) / elapsed.count());
+    }
+    return best;
+}
+
+static bool sameFeatures(const EvalFeatures& a, const EvalFeatures& b) {
+    return a.marbles == b.marbles && a.center == b.center && a.cohesion == b.cohesion &&
+           a.edge == b.edge && a.threats == b.threats;
+}
+
+int main(int argc, char* argv[]) {
+    // Usage: ./eval_benchmark <games> <rounds>
+    int games = 200;
+    int rounds = 50;
+    if (argc >= 2)
+        games = std::stoi(argv[1]);
+    if (argc >= 3)
+        rounds = std::stoi(argv[2]);
+
+    std::srand(1);
+    std::vector<std::array<uint64_t, 2>> positions = samplePositions(games);
+    std::vector<EvalFeatures> scalar(positions.size());
+    std::vector<EvalFeatures> batch(positions.size());
+
+    EvalBatch::computeFeaturesScalar(positions.data(), static_cast<int>(positions.size()), scalar.data());
+    EvalBatch::computeFeatures(positions.data(), static_cast<int>(positions.size()), batch.data());
+    int mismatches = 0;
+    for (size_t i = 0; i < positions.size(); i++) {
+        if (!sameFeatures(scalar[i], batch[i])) {
+            mismatches++;
+        }
+    }
+
+    // Both kernels against the engine's own per-position features and evaluation.
+    SearchOptions options;
+    options.threads = 1;
+    AbaloneAI ai(1, 0, 1, options);
+    int engineMismatches = 0;
+    for (Occupant toMove : { Occupant::BLACK, Occupant::WHITE }) {
+        std::vector<int> scores(positions.size());
+        ai.evaluateBatch(positions.data(), static_cast<int>(positions.size()), toMove, scores.data());
+        for (size_t i = 0; i < positions.size(); i++) {
+            Board board(positions[i], toMove);
+            if (!sameFeatures(ai.referenceFeatures(board), scalar[i]) || ai.referenceEvaluation(board) != scores[i]) {
+                engineMismatches++;
+            }
+        }
+    }
+
+    std::cout << "Positions: " << positions.size() << ", AVX2 kernel: " << (EvalBatch::vectorized() ? "yes" : "no")
+              << ", mismatches: " << mismatches << ", engine mismatches: " << engineMismatches << "\n";
+
+    double scalarRate = evalsPerSecond(EvalBatch::computeFeaturesScalar, positions, scalar, rounds);
+    double batchRate = evalsPerSecond(EvalBatch::computeFeatures, positions, batch, rounds);
+    std::cout << "Scalar: " << static_cast<long long>(scalarRate) << " evals/s\n";
+    std::cout << "Batch:  " << static_cast<long long>(batchRate) << " evals/s (x" << batchRate / scalarRate << ")\n";
+
+    return (mismatches == 0 && engineMismatches == 0) ? 0 : 1;
+}
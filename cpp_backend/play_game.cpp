@@ -11,12 +11,7 @@
 
 // Utility function to count marbles of a given side on the board.
 int countMarbles(const Board& board, Occupant side) {
-    int count = 0;
-    for (int i = 0; i < Board::NUM_CELLS; i++) {
-        if (board.occupant[i] == side)
-            count++;
-    }
-    return count;
+    return board.countMarbles(side);
 }
 
 int main(int argc, char* argv[]) {
@@ -64,6 +59,10 @@ int main(int argc, char* argv[]) {
 
     initialPositionFile << board.toBoardString() << std::endl;
 
+    // One engine for the whole game: its threads and transposition table
+    // carry over from move to move.
+    AbaloneAI ai(aiDepth, timeLimitMs);
+
     int moveCount = 0;
     while (true) {
         std::cout << "\nBoard state: " << board.toBoardString() << "\n";
@@ -82,7 +81,7 @@ int main(int argc, char* argv[]) {
         }
 
         // Generate legal moves for the current player.
-        std::vector<Move> legalMoves = board.generateMoves(board.nextToMove);
+        MoveList legalMoves = board.generateMoves(board.nextToMove);
         if (legalMoves.empty()) {
             if (board.nextToMove == Occupant::BLACK)
                 std::cout << "No legal moves for Black. White wins!\n";
@@ -102,8 +101,7 @@ int main(int argc, char* argv[]) {
             // Determine move selection based on the configuration mode.
             if (mode == "ai") {
                 // Both sides use AI.
-                AbaloneAI aiMove(aiDepth, timeLimitMs);
-                auto result = aiMove.findBestMoveIterativeDeepening(board, aiDepth);
+                auto result = ai.findBestMoveIterativeDeepening(board, aiDepth);
                 chosenMove = result.first;
                 std::cout << (board.nextToMove == Occupant::BLACK ? "Black" : "White")
                     << " (AI) chooses move: "
@@ -120,8 +118,7 @@ int main(int argc, char* argv[]) {
             else if (mode == "ai_vs_random") {
                 // Black uses AI; White chooses randomly.
                 if (board.nextToMove == Occupant::BLACK) {
-                    AbaloneAI aiMove(aiDepth, timeLimitMs);
-                    auto result = aiMove.findBestMoveIterativeDeepening(board, aiDepth);
+                    auto result = ai.findBestMoveIterativeDeepening(board, aiDepth);
                     chosenMove = result.first;
                     std::cout << "Black (AI) chooses move: "
                         << Board::moveToNotation(chosenMove, board.nextToMove) << "\n";
@@ -141,7 +138,7 @@ int main(int argc, char* argv[]) {
 
         // Attempt to apply the chosen move.
         try {
-            board.applyMove(chosenMove);
+            board.applyMoveChecked(chosenMove);
 
             // Write the new board state to possible moves file
             movesMadeFile << board.toBoardString() << std::endl;
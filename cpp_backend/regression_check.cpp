@@ -0,0 +1,240 @@
+// regression_check.cpp
+#include "Board.h"
+#include "AbaloneAI.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Checks the engine on a corpus of positions (regression/positions.txt: one per
+// line, name, side to move and marbles as in the .input files) against stored
+// expectations (regression/expected.txt), one line per position:
+//   moves   number of legal moves and a digest of generateMoves' list, in order
+//   scores  digest of evaluateMove's ordering score of every move
+//   eval    the static evaluation
+//   best    move code and score of a single-threaded depth-4 search
+// It also plays random walks from every position and checks that after each
+// move the search's incrementally updated features equal features computed
+// from scratch, and that Board's starting layouts are the corpus'
+// starting_position_input boards, which are the GUI's layouts (this needs no
+// stored data).
+//
+// Usage: ./regression_check <positions> <expected> [--write]
+// --write stores the current results as the expectations (after an intended change).
+
+struct Position {
+    std::string name;
+    Board board;
+};
+
+static const int SEARCH_DEPTH = 4;
+static const int WALK_PLIES = 40;
+
+struct Layout {
+    const char* name;
+    void (Board::*init)();
+};
+
+static const Layout LAYOUTS[] = {
+    { "starting_position_input/standard_start", &Board::initStandardLayout },
+    { "starting_position_input/belgian", &Board::initBelgianDaisyLayout },
+    { "starting_position_input/german", &Board::initGermanDaisyLayout },
+};
+
+// Reaches the engine internals that have no public interface.
+struct RegressionProbe {
+    static int evaluateMove(AbaloneAI& ai, const Board& board, const Move& move) {
+        return ai.evaluateMove(board, move, board.nextToMove);
+    }
+
+    // Walks WALK_PLIES random moves from 'board' with the search's make/unmake,
+    // comparing the incremental features after every legal move along the way
+    // with AbaloneAI::computeFeatures. Returns the number of positions that differed.
+    static int checkIncrementalFeatures(AbaloneAI& ai, Board board, unsigned seed, long long& checked);
+};
+
+static bool sameFeatures(const EvalFeatures& a, const EvalFeatures& b) {
+    return a.marbles == b.marbles && a.center == b.center && a.cohesion == b.cohesion &&
+           a.edge == b.edge && a.threats == b.threats;
+}
+
+int RegressionProbe::checkIncrementalFeatures(AbaloneAI& ai, Board board, unsigned seed, long long& checked) {
+    AbaloneAI::SearchWorker& worker = ai.workers[0];
+    worker.featureTop = 0;
+    worker.featureStack[0] = ai.computeFeatures(board);
+
+    std::mt19937 rng(seed);
+    std::vector<UndoInfo> path;
+    int mismatches = 0;
+    for (int ply = 0; ply < WALK_PLIES; ply++) {
+        MoveList moves = board.generateMoves(board.nextToMove);
+        if (moves.empty()) {
+            break;
+        }
+        for (int i = 0; i < moves.size(); i++) {
+            UndoInfo undo = ai.makeSearchMove(worker, board, moves[i]);
+            if (!sameFeatures(worker.features(), ai.computeFeatures(board))) {
+                mismatches++;
+            }
+            checked++;
+            ai.unmakeSearchMove(worker, board, undo);
+        }
+        path.push_back(ai.makeSearchMove(worker, board, moves[rng() % moves.size()]));
+    }
+    while (!path.empty()) {
+        ai.unmakeSearchMove(worker, board, path.back());
+        path.pop_back();
+    }
+    return mismatches;
+}
+
+static bool loadPositions(const std::string& filename, std::vector<Position>& positions) {
+    std::ifstream in(filename);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string side, marbles, cell;
+        Position position;
+        fields >> position.name >> side >> marbles;
+        position.board.nextToMove = (side == "b") ? Occupant::BLACK : Occupant::WHITE;
+        std::istringstream cells(marbles);
+        while (std::getline(cells, cell, ',')) {
+            Occupant who = (cell.back() == 'b') ? Occupant::BLACK : Occupant::WHITE;
+            position.board.setOccupant(cell.substr(0, cell.size() - 1), who);
+        }
+        positions.push_back(position);
+    }
+    return true;
+}
+
+// FNV-1a over 'text', continuing from 'hash'.
+static uint64_t digest(const std::string& text, uint64_t hash = 14695981039346656037ULL) {
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static std::string hex(uint64_t value) {
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(value));
+    return buffer;
+}
+
+// The expectation line of 'position' (without its name).
+static std::string describe(AbaloneAI& ai, const Position& position) {
+    const Board& board = position.board;
+    MoveList moves = board.generateMoves(board.nextToMove);
+    uint64_t moveDigest = digest("");
+    uint64_t scoreDigest = digest("");
+    for (int i = 0; i < moves.size(); i++) {
+        moveDigest = digest(Board::moveToNotation(moves[i], board.nextToMove) + ";", moveDigest);
+        scoreDigest = digest(std::to_string(RegressionProbe::evaluateMove(ai, board, moves[i])) + ";", scoreDigest);
+    }
+
+    // Each search starts from an empty table, so the result does not depend on the corpus order.
+    ai.newGame();
+    std::pair<Move, int> best = ai.analysePosition(board, SEARCH_DEPTH);
+
+    std::ostringstream out;
+    out << "moves " << moves.size() << " " << hex(moveDigest) << " scores " << hex(scoreDigest)
+        << " eval " << ai.referenceEvaluation(board) << " best " << best.first.code << " " << best.second;
+    return out.str();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <positions> <expected> [--write]\n";
+        return 2;
+    }
+    std::string positionsFile = argv[1];
+    std::string expectedFile = argv[2];
+    bool write = argc >= 4 && std::string(argv[3]) == "--write";
+
+    std::vector<Position> positions;
+    if (!loadPositions(positionsFile, positions)) {
+        std::cerr << "Cannot read " << positionsFile << "\n";
+        return 2;
+    }
+
+    SearchOptions options;
+    options.threads = 1;
+    AbaloneAI ai(SEARCH_DEPTH, 0, 16, options);
+
+    std::map<std::string, std::string> actual;
+    for (const Position& position : positions) {
+        actual[position.name] = describe(ai, position);
+    }
+
+    if (write) {
+        std::ofstream out(expectedFile);
+        for (const Position& position : positions) {
+            out << position.name << " " << actual[position.name] << "\n";
+        }
+        std::cout << "Wrote expectations for " << positions.size() << " positions to " << expectedFile << "\n";
+        return 0;
+    }
+
+    std::map<std::string, std::string> expected;
+    std::ifstream in(expectedFile);
+    if (!in) {
+        std::cerr << "Cannot read " << expectedFile << "\n";
+        return 2;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t space = line.find(' ');
+        if (space != std::string::npos) {
+            expected[line.substr(0, space)] = line.substr(space + 1);
+        }
+    }
+
+    int mismatches = 0;
+    for (const Position& position : positions) {
+        auto stored = expected.find(position.name);
+        if (stored == expected.end() || stored->second != actual[position.name]) {
+            mismatches++;
+            std::cout << position.name << ":\n  expected " << (stored == expected.end() ? "(none)" : stored->second)
+                      << "\n  actual   " << actual[position.name] << "\n";
+        }
+    }
+
+    int layoutMismatches = 0;
+    for (const Layout& layout : LAYOUTS) {
+        Board board;
+        (board.*layout.init)();
+        auto stored = std::find_if(positions.begin(), positions.end(),
+                                   [&](const Position& position) { return position.name == layout.name; });
+        if (stored == positions.end() || stored->board.toBoardString() != board.toBoardString()) {
+            layoutMismatches++;
+            std::cout << "Layout " << layout.name << " differs:\n  corpus "
+                      << (stored == positions.end() ? "(none)" : stored->board.toBoardString())
+                      << "\n  Board  " << board.toBoardString() << "\n";
+        }
+    }
+
+    long long checked = 0;
+    int featureMismatches = 0;
+    for (size_t p = 0; p < positions.size(); p++) {
+        featureMismatches += RegressionProbe::checkIncrementalFeatures(ai, positions[p].board,
+                                                                       static_cast<unsigned>(p + 1), checked);
+    }
+
+    std::cout << "Positions: " << positions.size() << ", mismatches: " << mismatches
+              << "; layout mismatches: " << layoutMismatches
+              << "; incremental features checked after " << checked << " moves, mismatches: " << featureMismatches
+              << "\n";
+    return (mismatches == 0 && layoutMismatches == 0 && featureMismatches == 0) ? 0 : 1;
+}
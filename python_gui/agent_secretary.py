@@ -3,7 +3,7 @@ import sys
 import random
 import platform
 from pathlib import Path
-from PyQt5 import QtWidgets
+from PyQt5 import QtWidgets, QtCore
 
 if platform.system() == "Darwin":  # macOS
     sys.path.insert(0, "../build")
@@ -11,14 +11,38 @@ if platform.system() == "Darwin":  # macOS
 import abalone_ai
 print(abalone_ai.__file__)
 
+# How often the GUI thread checks whether a background search has finished.
+SEARCH_POLL_INTERVAL_MS = 20
+
+
+class _ProgressRelay(QtCore.QObject):
+    """Carries progress reports from the engine's search thread to the GUI thread."""
+    progress = QtCore.pyqtSignal(dict)
+
+
 class AgentSecretary:
-    def __init__(self, game_view, depth=4, time_limit_ms=5000, tt_size_mb=128):
+    def __init__(self, game_view, depth=4, time_limit_ms=5000, tt_size_mb=128, ponder=True):
         self.latest_board = None
         self.game_view = game_view
         self.last_move_time = 0.0
         self.agent_total_time = 0.0
-        # Pass AI parameters to the C++ backend
-        self.ai = abalone_ai.AbaloneAI(depth, time_limit_ms, tt_size_mb)
+        # Pass AI parameters to the C++ backend. With ponder, the engine keeps
+        # searching on the opponent's time after playing its suggested move.
+        self.ai = abalone_ai.AbaloneAI(depth, time_limit_ms, tt_size_mb, ponder=ponder)
+
+        # The engine follows the game move by move (new_game, record_move,
+        # undo_move); if it ever loses track, the next search reloads the board.
+        self._session_synced = False
+
+        # Background search state (see request_move).
+        self._on_move = None
+        self._search_start = 0.0
+        self._poll_timer = QtCore.QTimer()
+        self._poll_timer.setInterval(SEARCH_POLL_INTERVAL_MS)
+        self._poll_timer.timeout.connect(self._poll_search)
+        self._progress_relay = _ProgressRelay()
+        self._progress_relay.progress.connect(self._on_progress)
+        self._progress_listener = None
 
     def get_board_state(self):
         return self.game_view.get_board_state()
@@ -29,12 +53,50 @@ class AgentSecretary:
             "White": self.game_view.white_scoreboard_model.turn_time_settings
         }
     
-    def send_state_to_agent(self, board_state):
-        print(f"[DEBUG] Board state string: {board_state}")
-        start_time = time.time()
+    def new_game(self, layout, moves_per_team):
+        """Start the engine's copy of a game from one of the standard layouts."""
+        self.cancel_search()
+        try:
+            self.ai.new_game(layout, moves_per_team)
+            self._session_synced = True
+        except ValueError as error:
+            print(f"[DEBUG] Agent cannot follow this game: {error}")
+            self._session_synced = False
+
+    def record_move(self, move_notation):
+        """Play a move made on the GUI board (either side's) in the engine's game."""
+        self.cancel_search()
+        if not self._session_synced or move_notation is None:
+            self._session_synced = False
+            return
+        try:
+            self.ai.apply_move(move_notation)
+        except ValueError as error:
+            print(f"[DEBUG] Agent lost track of the game: {error}")
+            self._session_synced = False
+
+    def undo_move(self):
+        """Take back the last move in the engine's game."""
+        self.cancel_search()
+        if not self._session_synced:
+            return
+        try:
+            self.ai.undo()
+        except IndexError:
+            self._session_synced = False
+
+    def _prepare_search(self, board_state):
+        """Make sure the engine has board_state; return (move count, total move limit)."""
+        if not self._session_synced:
+            # The board is sent in full only when the engine's game is out of step.
+            print(f"[DEBUG] Board state string: {board_state}")
+            self.ai.parse_board_state(
+                board_state,
+                self.game_view.black_scoreboard_model.num_moves_made,
+                self.game_view.white_scoreboard_model.num_moves_made,
+            )
+            self._session_synced = True
 
-        self.ai.parse_board_state(board_state)
-        
         # Determine current move count based on current player.
         first_line = board_state.splitlines()[0].strip()
         if first_line.lower() == 'b':
@@ -49,9 +111,9 @@ class AgentSecretary:
             if self.game_view._config is not None else 100
         )
         print(f"[DEBUG] Total moves limit: {total_move_limit}")
+        return current_move_count, total_move_limit
 
-        move, updated_board = self.ai.find_best_move(current_move_count, total_move_limit)
-        
+    def _record_move(self, move, updated_board, start_time):
         # Debug message to show the AI call worked.
         print("[DEBUG] AI move computed successfully.")
         print(f"[DEBUG] Move from C++: {move}")
@@ -64,9 +126,80 @@ class AgentSecretary:
         move_time = time.time() - start_time
         self.last_move_time = move_time
         self.agent_total_time += move_time
+        return move_time
+
+    def send_state_to_agent(self, board_state):
+        """Search board_state and return (move, move_time). Blocks until the move is found."""
+        start_time = time.time()
+        current_move_count, total_move_limit = self._prepare_search(board_state)
+
+        move, updated_board = self.ai.find_best_move(current_move_count, total_move_limit)
+        # find_best_move plays the move itself; the GUI will report it again.
+        self._session_synced = False
+        move_time = self._record_move(move, updated_board, start_time)
 
         return move, move_time  # Return only 2 values to avoid unpacking error
 
+    def request_move(self, board_state, on_move, on_progress=None):
+        """
+        Start searching board_state without blocking the GUI thread.
+        on_move(move, move_time) is called on the GUI thread once the move is found;
+        on_progress(info), if given, after every completed search depth with the
+        engine's depth, score, nodes, elapsed_ms and move.
+        """
+        self.cancel_search()
+        current_move_count, total_move_limit = self._prepare_search(board_state)
+
+        self._on_move = on_move
+        self._progress_listener = on_progress
+        self._search_start = time.time()
+        # Runs on the engine's search thread: only hand the report over to the GUI thread.
+        # The move is only suggested: it is played when the GUI reports it (record_move).
+        self.ai.start_search(current_move_count, total_move_limit, self._progress_relay.progress.emit, play=False)
+        self._poll_timer.start()
+
+    def is_searching(self):
+        return self._poll_timer.isActive()
+
+    def stop_search(self):
+        """Finish the running search now; on_move receives the best move found so far."""
+        if not self._poll_timer.isActive():
+            return
+        self._poll_timer.stop()
+        result = self.ai.stop()
+        if result is not None:
+            self._deliver(*result)
+
+    def cancel_search(self):
+        """Abandon the running search (e.g. on restart); on_move is not called."""
+        if not self._poll_timer.isActive():
+            return
+        self._poll_timer.stop()
+        self.ai.stop()
+        self._on_move = None
+        self._progress_listener = None
+
+    def _poll_search(self):
+        result = self.ai.poll()
+        if result is None:
+            return
+        self._poll_timer.stop()
+        self._deliver(*result)
+
+    def _deliver(self, move, updated_board):
+        move_time = self._record_move(move, updated_board, self._search_start)
+        on_move = self._on_move
+        self._on_move = None
+        self._progress_listener = None
+        if on_move is not None:
+            on_move(move, move_time)
+
+    def _on_progress(self, info):
+        print(f"[DEBUG] Depth {info['depth']}: {info['move']} score {info['score']}, "
+              f"{info['nodes']} nodes, {info['elapsed_ms']} ms")
+        if self._progress_listener is not None:
+            self._progress_listener(info)
+
     # Uncomment or add additional methods as needed.
     # @staticmethod
     # def generate_random_move():
@@ -0,0 +1,45 @@
+"""
+Checks that the engine starts a game from the board the GUI shows: for every
+layout, AbaloneAI.new_game(layout) followed by get_current_board_string() must
+give the marbles GameBoard.set_layout(layout) places.
+
+Run it from python_gui, like main_app.py:  python check_layouts.py
+"""
+import os
+import sys
+
+# No window is shown; the board only needs a QApplication to exist.
+os.environ.setdefault("QT_QPA_PLATFORM", "offscreen")
+
+from PyQt5 import QtWidgets
+sys.path.append(os.path.abspath(os.path.join(os.path.dirname(__file__), "..")))
+
+from python_gui.game_screen.game_board import GameBoard
+import abalone_ai
+
+LAYOUTS = ["Standard", "Belgian Daisy", "German Daisy"]
+
+
+def main():
+    app = QtWidgets.QApplication(sys.argv)
+    board = GameBoard()
+    ai = abalone_ai.AbaloneAI(tt_size_mb=1, threads=1)
+    failures = 0
+    for layout in LAYOUTS:
+        board.set_layout(layout)
+        gui_cells = set(board.get_board_state().splitlines()[1].split(","))
+        ai.new_game(layout)
+        engine_cells = set(ai.get_current_board_string().split(","))
+        if gui_cells == engine_cells:
+            print(f"{layout}: OK ({len(gui_cells)} marbles)")
+        else:
+            failures += 1
+            print(f"{layout}: the engine's board differs from the GUI's")
+            print(f"  only in the GUI:    {','.join(sorted(gui_cells - engine_cells))}")
+            print(f"  only in the engine: {','.join(sorted(engine_cells - gui_cells))}")
+    app.quit()
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
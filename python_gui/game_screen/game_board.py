@@ -75,6 +75,9 @@ class GameBoard:
         self.turn_start_time = time.time()  # Track turn start
         self.move_callback = None  # Callback to GameView
         self.ai_update_callback = None
+        self.undo_callback = None
+        # The last confirmed move in the C++ engine's notation, e.g. "(b, C3, B2) i → NE".
+        self.last_move_notation = None
 
     def clear_board(self):
         self._selected_tiles = []
@@ -495,6 +498,9 @@ class GameBoard:
             from_coords = [src]
             to_coords = [destination_coord]
             captured = []
+            step = (destination_coord[0] - src[0], destination_coord[1] - src[1])
+            direction = next((name for name, delta in self.DIRECTIONS.items() if delta == step), None)
+            move_type = "i"
             self._move_single(src, destination_coord)
         else:
             alignment_dir, sorted_tiles, is_collinear = self._analyze_selection(self._selected_tiles)
@@ -504,15 +510,22 @@ class GameBoard:
             chosen_move = next((mv for mv in possible_moves if destination_coord in mv["highlight_coords"]), None)
             if not chosen_move:
                 return
-            dx, dy = self.DIRECTIONS[chosen_move["direction"]]
+            direction = chosen_move["direction"]
+            dx, dy = self.DIRECTIONS[direction]
             from_coords = sorted_tiles
             to_coords = self._compute_destination(sorted_tiles, dx, dy)
             if self._is_inline(alignment_dir, (dx, dy)):
+                move_type = "i"
                 captured = self._apply_inline_move(sorted_tiles, dx, dy, color_of_selection)
             else:
+                move_type = "s"
                 self._apply_sidestep_move(sorted_tiles, dx, dy)
                 captured = []
 
+        # The same move as the engine writes it, so the agent can follow the game move by move.
+        cells = sorted((self._coord_to_str(*coord) for coord in from_coords), reverse=True)
+        self.last_move_notation = f"({color_of_selection[0].lower()}, {', '.join(cells)}) {move_type} → {direction}"
+
         # Format move description
         from_str = [self._coord_to_str(*coord) for coord in from_coords]
         to_str = [self._coord_to_str(*coord) for coord in to_coords]
@@ -601,6 +614,9 @@ class GameBoard:
         self._clear_options()
         self._clear_selected()
 
+        if self.undo_callback:
+            self.undo_callback()
+
         # Update AI information if callback exists
         if self.ai_update_callback:
             self.ai_update_callback(self.get_board_state())
@@ -916,6 +932,10 @@ class GameBoard:
     def set_ai_update_callback(self, callback):
         self.ai_update_callback = callback
 
+    def set_undo_callback(self, callback):
+        """Set the callback function to notify GameView of an undone move."""
+        self.undo_callback = callback
+
     def highlight_suggested_move(self, parsed_move):
         """Highlight the AI-suggested move by selecting tiles and setting destination options."""
         # Clear existing highlights
@@ -56,6 +56,7 @@ class GameView(QtWidgets.QWidget):
         self.agent_secretary = AgentSecretary(self)
         self.info_panel_view = InfoPanelView(self, self.info_panel_model)
         self.game_board.set_ai_update_callback(self.update_ai_information)
+        self.game_board.set_undo_callback(self.on_move_undone)
 
         # Create left column: Black Scoreboard (top) and Move History (bottom).
         left_column = QtWidgets.QWidget()
@@ -187,7 +188,11 @@ class GameView(QtWidgets.QWidget):
             if self._config.host_colour.lower()[0] == current_player:
                 return
 
-        next_move, move_time = self.agent_secretary.send_state_to_agent(board_state)
+        # The search runs in the background; the board, clocks and buttons stay live.
+        self.agent_secretary.request_move(board_state, self.show_suggested_move)
+
+    def show_suggested_move(self, next_move, move_time):
+        """Highlight the move the agent found and show it in the info panel."""
         parsed_move = self.game_board.parse_move(next_move)
         self.game_board.highlight_suggested_move(parsed_move)
         self.info_panel_model.next_move = next_move
@@ -197,6 +202,7 @@ class GameView(QtWidgets.QWidget):
 
     def on_move_made(self, move_description):
         """Handle move data from GameBoard."""
+        self.agent_secretary.record_move(self.game_board.last_move_notation)
         self.move_history_model.add_move(move_description)
         self.move_history_view.refresh()
         
@@ -217,6 +223,10 @@ class GameView(QtWidgets.QWidget):
         elif self.match_type == "Computer vs Computer":
             QtCore.QTimer.singleShot(500, lambda: self.update_ai_information(self.game_board.get_board_state()))
 
+    def on_move_undone(self):
+        """Take the move back in the agent's game as well."""
+        self.agent_secretary.undo_move()
+
     def show_win_screen(self):
         """Display the winning screen."""
         self.win_screen.show()
@@ -224,6 +234,7 @@ class GameView(QtWidgets.QWidget):
 
     def set_config(self, config_data):
         """Called when the user finalizes the game configuration."""
+        self.agent_secretary.cancel_search()
         self._config = config_data
         board_layout = config_data.board_layout
         # host_colour = config_data.host_colour
@@ -248,6 +259,7 @@ class GameView(QtWidgets.QWidget):
         self.game_board.current_player = "Black"
 
         self.game_board.set_layout(board_layout)
+        self.agent_secretary.new_game(board_layout, config_data.moves_per_team)
 
         # For AI matches, trigger an initial AI update after a delay.
         initial_board_state = self.game_board.get_board_state()
@@ -260,6 +272,7 @@ class GameView(QtWidgets.QWidget):
 
     def reset_game(self):
         """Reset all game state to initial conditions."""
+        self.agent_secretary.cancel_search()
         self.black_scoreboard_model.reset()
         self.white_scoreboard_model.reset()
         self.black_scoreboard_model.is_active = True
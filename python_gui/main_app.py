@@ -61,6 +61,7 @@ class MainApp(QtWidgets.QMainWindow):
             ai_time_limit_ms=settings_model.ai_time_limit_ms
         )
         # Reinitialize AgentSecretary with the new AI parameters.
+        self.game_view.agent_secretary.cancel_search()
         self.game_view.agent_secretary = AgentSecretary(
             self.game_view,
             depth=game_config.ai_max_depth,